@@ -13,6 +13,7 @@
 #endif // _HAS_CXX20
 #endif // _MAYBE_UNUSED
 
+#if _HAS_WINDOWS
 int __stdcall DllMain(HMODULE, unsigned long _Reason, _MAYBE_UNUSED void*) {
     switch (_Reason) {
     case DLL_PROCESS_ATTACH:
@@ -24,6 +25,7 @@ int __stdcall DllMain(HMODULE, unsigned long _Reason, _MAYBE_UNUSED void*) {
 
     return 1;
 }
+#endif // _HAS_WINDOWS
 
 // won't be used anymore
 #ifdef _MAYBE_UNUSED
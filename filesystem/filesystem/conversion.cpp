@@ -6,100 +6,514 @@
 #include <filesystem_pch.hpp>
 #include <filesystem.hpp>
 
-#if !_HAS_WINDOWS
-#pragma message("The contents of <conversion.cpp> are available only with Windows 10.")
-#else // ^^^ !_HAS_WINDOWS ^^^ / vvv _HAS_WINDOWS vvv
-#pragma warning(push)
-#pragma warning(disable : 4996) // C4996: using deprecated content (<codecvt>)
-
 _FILESYSTEM_BEGIN
+// FUNCTION _Is_surrogate
+_NODISCARD constexpr bool _Is_surrogate(const char32_t _Code) noexcept {
+    return _Code >= 0xD800 && _Code <= 0xDFFF;
+}
+
+// FUNCTION _Decode_utf8
+_NODISCARD char32_t _Decode_utf8(const unsigned char* const _First, const size_t _Size, size_t& _Length) noexcept {
+    // decodes one multi-byte sequence, returns char32_t(-1) if the sequence is not valid
+    constexpr char32_t _Invalid = static_cast<char32_t>(-1);
+    const unsigned char _Lead{_First[0]};
+    char32_t _Code;
+    char32_t _Min; // the smallest code point that needs _Length bytes (rejects overlong sequences)
+    if ((_Lead & 0xE0) == 0xC0) {
+        _Length = 2;
+        _Code   = _Lead & 0x1F;
+        _Min    = 0x80;
+    } else if ((_Lead & 0xF0) == 0xE0) {
+        _Length = 3;
+        _Code   = _Lead & 0x0F;
+        _Min    = 0x800;
+    } else if ((_Lead & 0xF8) == 0xF0) {
+        _Length = 4;
+        _Code   = _Lead & 0x07;
+        _Min    = 0x10000;
+    } else { // unexpected continuation byte or invalid lead byte
+        _Length = 1;
+        return _Invalid;
+    }
+
+    if (_Size < _Length) { // truncated sequence
+        _Length = 1;
+        return _Invalid;
+    }
+
+    for (size_t _Idx = 1; _Idx < _Length; ++_Idx) {
+        if ((_First[_Idx] & 0xC0) != 0x80) { // not a continuation byte
+            _Length = 1;
+            return _Invalid;
+        }
+
+        _Code = (_Code << 6) | (_First[_Idx] & 0x3F);
+    }
+
+    if (_Code < _Min || _Code > 0x10FFFF || _Is_surrogate(_Code)) {
+        _Length = 1;
+        return _Invalid;
+    }
+
+    return _Code;
+}
+
+// FUNCTION TEMPLATE _Utf8_to_utf
+template <class _Elem>
+_NODISCARD size_t _Utf8_to_utf(
+    const char* const _First, const size_t _Size, _Elem* const _Dest, const bool _Strict) noexcept {
+    static_assert(sizeof(_Elem) == 2 || sizeof(_Elem) == 4, "UTF-16 or UTF-32 code unit required");
+    const unsigned char* const _Src{reinterpret_cast<const unsigned char*>(_First)};
+    size_t _In{0};
+    size_t _Out{0};
+#if _FILESYSTEM_SSE2
+    size_t _Scalar_end{0}; // end of the last block that failed the vector loop
+#endif // _FILESYSTEM_SSE2
+    while (_In < _Size) {
+#if _FILESYSTEM_SSE2
+        if (_In >= _Scalar_end) { // vector loop, unless inside a block that already failed it
+            // paths are mostly ASCII, widen 16 characters at a time until the first non-ASCII byte
+            const __m128i _Zero{_mm_setzero_si128()};
+            while (_Size - _In >= 16) {
+                const __m128i _Chunk{_mm_loadu_si128(reinterpret_cast<const __m128i*>(_Src + _In))};
+                if (_mm_movemask_epi8(_Chunk) != 0) { // at least one byte with the high bit set
+                    break;
+                }
+
+                const __m128i _Low{_mm_unpacklo_epi8(_Chunk, _Zero)};
+                const __m128i _High{_mm_unpackhi_epi8(_Chunk, _Zero)};
+                __m128i* const _Target{reinterpret_cast<__m128i*>(_Dest + _Out)};
+                if constexpr (sizeof(_Elem) == 2) {
+                    _mm_storeu_si128(_Target, _Low);
+                    _mm_storeu_si128(_Target + 1, _High);
+                } else {
+                    _mm_storeu_si128(_Target, _mm_unpacklo_epi16(_Low, _Zero));
+                    _mm_storeu_si128(_Target + 1, _mm_unpackhi_epi16(_Low, _Zero));
+                    _mm_storeu_si128(_Target + 2, _mm_unpacklo_epi16(_High, _Zero));
+                    _mm_storeu_si128(_Target + 3, _mm_unpackhi_epi16(_High, _Zero));
+                }
+
+                _In += 16;
+                _Out += 16;
+            }
+
+            if (_In == _Size) {
+                break;
+            }
+
+            _Scalar_end = _In + 16; // finish this mixed block without retrying the vector loop
+        }
+#endif // _FILESYSTEM_SSE2
+
+        if (_Src[_In] < 0x80) { // ASCII character
+            _Dest[_Out++] = static_cast<_Elem>(_Src[_In++]);
+            continue;
+        }
+
+        size_t _Length;
+        char32_t _Code{_Decode_utf8(_Src + _In, _Size - _In, _Length)};
+        if (_Code == static_cast<char32_t>(-1)) {
+            if (_Strict) {
+                return _Transcode_error;
+            }
+
+            _Code = 0xFFFD; // replacement character
+        }
+
+        _In += _Length;
+        if constexpr (sizeof(_Elem) == 2) {
+            if (_Code >= 0x10000) { // encode as surrogate pair
+                _Code -= 0x10000;
+                _Dest[_Out++] = static_cast<_Elem>(0xD800 + (_Code >> 10));
+                _Dest[_Out++] = static_cast<_Elem>(0xDC00 + (_Code & 0x3FF));
+                continue;
+            }
+        }
+
+        _Dest[_Out++] = static_cast<_Elem>(_Code);
+    }
+
+    return _Out;
+}
+
+template _NODISCARD size_t _Utf8_to_utf(const char* const, const size_t, char16_t* const, const bool) noexcept;
+template _NODISCARD size_t _Utf8_to_utf(const char* const, const size_t, char32_t* const, const bool) noexcept;
+template _NODISCARD size_t _Utf8_to_utf(const char* const, const size_t, wchar_t* const, const bool) noexcept;
+
+// FUNCTION TEMPLATE _Decode_utf
+template <class _Elem>
+_NODISCARD char32_t _Decode_utf(const _Elem* const _First, const size_t _Size, size_t& _In) noexcept {
+    // decodes one UTF-16 or UTF-32 code point at _In, returns char32_t(-1) if it's not valid
+    char32_t _Code{static_cast<char32_t>(_First[_In++])};
+    if constexpr (sizeof(_Elem) == 2) {
+        _Code &= 0xFFFF;
+        if (_Code >= 0xD800 && _Code <= 0xDBFF && _In < _Size
+            && (_First[_In] & 0xFC00) == 0xDC00) { // high and low surrogate
+            return 0x10000 + ((_Code - 0xD800) << 10) + (static_cast<char32_t>(_First[_In++]) & 0x3FF);
+        }
+
+        return _Is_surrogate(_Code) ? static_cast<char32_t>(-1) : _Code; // unpaired surrogate
+    } else {
+        return _Code <= 0x10FFFF && !_Is_surrogate(_Code) ? _Code : static_cast<char32_t>(-1);
+    }
+}
+
+// FUNCTION _Utf8_size
+_NODISCARD constexpr size_t _Utf8_size(const char32_t _Code) noexcept {
+    return _Code < 0x80 ? 1 : _Code < 0x800 ? 2 : _Code < 0x10000 ? 3 : 4;
+}
+
+#if _FILESYSTEM_SSE2
+// FUNCTION TEMPLATE _Pack_ascii_block
+template <class _Elem>
+_NODISCARD bool _Pack_ascii_block(const _Elem* const _First, __m128i& _Packed) noexcept {
+    // narrows 16 code units to bytes if all of them are ASCII, the packing saturates, so check the range first
+    const __m128i _Zero{_mm_setzero_si128()};
+    const __m128i* const _Source{reinterpret_cast<const __m128i*>(_First)};
+    if constexpr (sizeof(_Elem) == 2) {
+        const __m128i _Low{_mm_loadu_si128(_Source)};
+        const __m128i _High{_mm_loadu_si128(_Source + 1)};
+        const __m128i _Outside{
+            _mm_and_si128(_mm_or_si128(_Low, _High), _mm_set1_epi16(static_cast<short>(0xFF80)))};
+        if (_mm_movemask_epi8(_mm_cmpeq_epi16(_Outside, _Zero)) != 0xFFFF) {
+            return false;
+        }
+
+        _Packed = _mm_packus_epi16(_Low, _High);
+    } else {
+        const __m128i _First4{_mm_loadu_si128(_Source)};
+        const __m128i _Second4{_mm_loadu_si128(_Source + 1)};
+        const __m128i _Third4{_mm_loadu_si128(_Source + 2)};
+        const __m128i _Fourth4{_mm_loadu_si128(_Source + 3)};
+        const __m128i _Outside{_mm_and_si128(
+            _mm_or_si128(_mm_or_si128(_First4, _Second4), _mm_or_si128(_Third4, _Fourth4)),
+            _mm_set1_epi32(static_cast<int>(0xFFFFFF80)))};
+        if (_mm_movemask_epi8(_mm_cmpeq_epi32(_Outside, _Zero)) != 0xFFFF) {
+            return false;
+        }
+
+        _Packed = _mm_packus_epi16(_mm_packs_epi32(_First4, _Second4), _mm_packs_epi32(_Third4, _Fourth4));
+    }
+
+    return true;
+}
+#endif // _FILESYSTEM_SSE2
+
+// FUNCTION TEMPLATE _Utf_to_utf8
+template <class _Elem>
+_NODISCARD size_t _Utf_to_utf8(
+    const _Elem* const _First, const size_t _Size, char* const _Dest, const bool _Strict) noexcept {
+    static_assert(sizeof(_Elem) == 2 || sizeof(_Elem) == 4, "UTF-16 or UTF-32 code unit required");
+    size_t _In{0};
+    size_t _Out{0};
+#if _FILESYSTEM_SSE2
+    size_t _Scalar_end{0}; // end of the last block that failed the vector loop
+#endif // _FILESYSTEM_SSE2
+    while (_In < _Size) {
+#if _FILESYSTEM_SSE2
+        if (_In >= _Scalar_end) { // vector loop, unless inside a block that already failed it
+            __m128i _Packed;
+            while (_Size - _In >= 16 && _Pack_ascii_block(_First + _In, _Packed)) { // 16 ASCII code units at a time
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(_Dest + _Out), _Packed);
+                _In += 16;
+                _Out += 16;
+            }
+
+            if (_In == _Size) {
+                break;
+            }
+
+            _Scalar_end = _In + 16; // finish this mixed block without retrying the vector loop
+        }
+#endif // _FILESYSTEM_SSE2
+
+        char32_t _Code{_Decode_utf(_First, _Size, _In)};
+        if (_Code == static_cast<char32_t>(-1)) {
+            if (_Strict) {
+                return _Transcode_error;
+            }
+
+            _Code = 0xFFFD; // replacement character
+        }
+
+        if (_Code < 0x80) {
+            _Dest[_Out++] = static_cast<char>(_Code);
+        } else if (_Code < 0x800) {
+            _Dest[_Out++] = static_cast<char>(0xC0 | (_Code >> 6));
+            _Dest[_Out++] = static_cast<char>(0x80 | (_Code & 0x3F));
+        } else if (_Code < 0x10000) {
+            _Dest[_Out++] = static_cast<char>(0xE0 | (_Code >> 12));
+            _Dest[_Out++] = static_cast<char>(0x80 | ((_Code >> 6) & 0x3F));
+            _Dest[_Out++] = static_cast<char>(0x80 | (_Code & 0x3F));
+        } else {
+            _Dest[_Out++] = static_cast<char>(0xF0 | (_Code >> 18));
+            _Dest[_Out++] = static_cast<char>(0x80 | ((_Code >> 12) & 0x3F));
+            _Dest[_Out++] = static_cast<char>(0x80 | ((_Code >> 6) & 0x3F));
+            _Dest[_Out++] = static_cast<char>(0x80 | (_Code & 0x3F));
+        }
+    }
+
+    return _Out;
+}
+
+template _NODISCARD size_t _Utf_to_utf8(const char16_t* const, const size_t, char* const, const bool) noexcept;
+template _NODISCARD size_t _Utf_to_utf8(const char32_t* const, const size_t, char* const, const bool) noexcept;
+template _NODISCARD size_t _Utf_to_utf8(const wchar_t* const, const size_t, char* const, const bool) noexcept;
+
+// FUNCTION TEMPLATE _Utf_length
+template <class _Elem>
+_NODISCARD size_t _Utf_length(const string_view _Input) noexcept {
+    // counts code units written by _Utf8_to_utf() (invalid sequences counted as U+FFFD)
+    const unsigned char* const _Src{reinterpret_cast<const unsigned char*>(_Input.data())};
+    const size_t _Size{_Input.size()};
+    size_t _In{0};
+    size_t _Count{0};
+#if _FILESYSTEM_SSE2
+    size_t _Scalar_end{0}; // end of the last block that failed the vector loop
+#endif // _FILESYSTEM_SSE2
+    while (_In < _Size) {
+#if _FILESYSTEM_SSE2
+        if (_In >= _Scalar_end) { // vector loop, unless inside a block that already failed it
+            while (_Size - _In >= 16
+                   && _mm_movemask_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(_Src + _In))) == 0) {
+                _In += 16; // every ASCII byte is one code unit
+                _Count += 16;
+            }
+
+            if (_In == _Size) {
+                break;
+            }
+
+            _Scalar_end = _In + 16; // finish this mixed block without retrying the vector loop
+        }
+#endif // _FILESYSTEM_SSE2
+
+        if (_Src[_In] < 0x80) {
+            ++_In;
+            ++_Count;
+            continue;
+        }
+
+        size_t _Length;
+        const char32_t _Code{_Decode_utf8(_Src + _In, _Size - _In, _Length)};
+        _In += _Length;
+        _Count += sizeof(_Elem) == 2 && _Code != static_cast<char32_t>(-1) && _Code >= 0x10000 ? 2 : 1;
+    }
+
+    return _Count;
+}
+
+// FUNCTION TEMPLATE _Utf8_length
+template <class _Elem>
+_NODISCARD size_t _Utf8_length(const basic_string_view<_Elem> _Input) noexcept {
+    // counts bytes written by _Utf_to_utf8() (invalid code units counted as U+FFFD)
+    const size_t _Size{_Input.size()};
+    size_t _In{0};
+    size_t _Count{0};
+#if _FILESYSTEM_SSE2
+    size_t _Scalar_end{0}; // end of the last block that failed the vector loop
+#endif // _FILESYSTEM_SSE2
+    while (_In < _Size) {
+#if _FILESYSTEM_SSE2
+        if (_In >= _Scalar_end) { // vector loop, unless inside a block that already failed it
+            __m128i _Packed;
+            while (_Size - _In >= 16 && _Pack_ascii_block(_Input.data() + _In, _Packed)) {
+                _In += 16; // every ASCII code unit is one byte
+                _Count += 16;
+            }
+
+            if (_In == _Size) {
+                break;
+            }
+
+            _Scalar_end = _In + 16; // finish this mixed block without retrying the vector loop
+        }
+#endif // _FILESYSTEM_SSE2
+
+        const char32_t _Code{_Decode_utf(_Input.data(), _Size, _In)};
+        _Count += _Code == static_cast<char32_t>(-1) ? 3 : _Utf8_size(_Code); // U+FFFD takes 3 bytes
+    }
+
+    return _Count;
+}
+
+// FUNCTION TEMPLATE _Utf8_to_utf_string
+template <class _Elem, class _Traits, class _Alloc>
+_NODISCARD basic_string<_Elem, _Traits, _Alloc> _Utf8_to_utf_string(const string_view _Input, const char* const _Src) {
+    // UTF-16 and UTF-32 never need more code units than UTF-8 needs bytes
+    basic_string<_Elem, _Traits, _Alloc> _Output(_Input.size(), _Elem{});
+    const size_t _Count{_Utf8_to_utf(_Input.data(), _Input.size(), _Output.data(), true)};
+    if (_Count == _Transcode_error) {
+        _Throw_system_error(_Src, "conversion failed", error_type::runtime_error);
+    }
+
+    _Output.resize(_Count);
+    return _Output;
+}
+
+// FUNCTION TEMPLATE _Utf_to_utf8_string
+template <class _Elem, class _Traits>
+_NODISCARD string _Utf_to_utf8_string(const basic_string_view<_Elem, _Traits> _Input, const char* const _Src) {
+    constexpr size_t _Max_bytes = sizeof(_Elem) == 2 ? 3 : 4; // the worst case per code unit
+    if (_Input.size() <= _Max_path) { // short input (most paths), convert on the stack and copy once
+        char _Buff[_Max_path * _Max_bytes];
+        const size_t _Count{_Utf_to_utf8(_Input.data(), _Input.size(), _Buff, true)};
+        if (_Count == _Transcode_error) {
+            _Throw_system_error(_Src, "conversion failed", error_type::runtime_error);
+        }
+
+        return string(_Buff, _Count);
+    }
+
+    // measure first, allocating the worst case for long input would waste memory
+    string _Output(_Utf8_length(basic_string_view<_Elem>{_Input.data(), _Input.size()}), '\0');
+    if (_Utf_to_utf8(_Input.data(), _Input.size(), _Output.data(), true) == _Transcode_error) {
+        _Throw_system_error(_Src, "conversion failed", error_type::runtime_error);
+    }
+
+    return _Output;
+}
+
 // FUNCTION _Convert_narrow_to_wide
 _NODISCARD wstring _Convert_narrow_to_wide(const code_page _Cp, const string_view _Input) {
     if (!_Input.empty()) {
-        if (_Input.size() > static_cast<size_t>(INT_MAX)) {
+#if _HAS_WINDOWS
+        if (_Cp == code_page::acp) { // the ANSI code page depends on the system, let Windows convert it
+            wstring _Output(_Input.size(), L'\0'); // one wide character per byte is always enough
+            _Output.resize(_Convert_narrow_to_wide(_Cp, _Input, _Output));
+            return _Output;
+        }
+#else // ^^^ _HAS_WINDOWS ^^^ / vvv !_HAS_WINDOWS vvv
+        // Linux uses UTF-8 everywhere, so code_page::acp is the same as code_page::utf8.
+        // The wchar_t is 4 bytes long and stores UTF-32 characters.
+        (void) _Cp;
+#endif // _HAS_WINDOWS
+        return _Utf8_to_utf_string<wchar_t, char_traits<wchar_t>, allocator<wchar_t>>(
+            _Input, "_Convert_narrow_to_wide");
+    }
+
+    return wstring();
+}
+
+_NODISCARD size_t _Convert_narrow_to_wide(const code_page _Cp, const string_view _Input, const span<wchar_t> _Output) {
+    if (_Input.empty()) {
+        return 0;
+    }
+
+#if _HAS_WINDOWS
+    if (_Cp == code_page::acp) { // the ANSI code page depends on the system, let Windows convert it
+        if (_Input.size() > static_cast<size_t>(INT_MAX)) { // limited by the Windows API
             _Throw_system_error("_Convert_narrow_to_wide", "invalid length", error_type::length_error);
         }
 
-        wstring _Output;
-        const int _Input_size  = static_cast<int>(_Input.size());
-        const int _Output_size = _Input_size; // the same size
-    
-        // The MultiByteToWideChar() replaces multi byte to wide characters,
-        // so _Output size must be same as _Input size.
-        _Output.resize(_Output_size, L' ');
-        if (!MultiByteToWideChar(static_cast<uint32_t>(_Cp), MB_ERR_INVALID_CHARS,
-            _Input.data(), _Input_size, _Output.data(), _Output_size)) { 
+        const int _Count{MultiByteToWideChar(static_cast<uint32_t>(_Cp), MB_ERR_INVALID_CHARS, _Input.data(),
+            static_cast<int>(_Input.size()), _Output.data(), static_cast<int>((_STD min)(_Output.size(),
+            static_cast<size_t>(INT_MAX))))};
+        if (_Count == 0) {
             _Throw_system_error("_Convert_narrow_to_wide", "conversion failed", error_type::runtime_error);
         }
 
-        if (_Output.size() > _Input.size()) { // additional characters
-            _Output.resize(_Output_size);
-        }
+        return static_cast<size_t>(_Count);
+    }
+#else // ^^^ _HAS_WINDOWS ^^^ / vvv !_HAS_WINDOWS vvv
+    (void) _Cp;
+#endif // _HAS_WINDOWS
+    if (_Output.size() < _Input.size() && _Output.size() < _Utf_length<wchar_t>(_Input)) { // measure only if needed
+        _Throw_system_error("_Convert_narrow_to_wide", "buffer too small", error_type::length_error);
+    }
 
-        return _Output;
+    const size_t _Count{_Utf8_to_utf(_Input.data(), _Input.size(), _Output.data(), true)};
+    if (_Count == _Transcode_error) {
+        _Throw_system_error("_Convert_narrow_to_wide", "conversion failed", error_type::runtime_error);
     }
 
-    return wstring();
+    return _Count;
 }
 
 // FUNCTION _Convert_wide_to_narrow
 _NODISCARD string _Convert_wide_to_narrow(const code_page _Cp, const wstring_view _Input) {
     if (!_Input.empty()) {
-        if (_Input.size() > static_cast<size_t>(INT_MAX)) {
-            _Throw_system_error("_Convert_wide_to_narrow", "invalid length", error_type::length_error);
+#if _HAS_WINDOWS
+        if (_Cp == code_page::acp) { // the ANSI code page depends on the system, let Windows convert it
+            if (_Input.size() > static_cast<size_t>(INT_MAX)) { // limited by the Windows API
+                _Throw_system_error("_Convert_wide_to_narrow", "invalid length", error_type::length_error);
+            }
+
+            const int _Output_size{WideCharToMultiByte(static_cast<uint32_t>(_Cp), 0,
+                _Input.data(), static_cast<int>(_Input.size()), nullptr, 0, nullptr, nullptr)}; // only measure
+            if (_Output_size == 0) {
+                _Throw_system_error("_Convert_wide_to_narrow", "conversion failed", error_type::runtime_error);
+            }
+
+            string _Output(static_cast<size_t>(_Output_size), '\0');
+            (void) _Convert_wide_to_narrow(_Cp, _Input, _Output);
+            return _Output;
         }
+#else // ^^^ _HAS_WINDOWS ^^^ / vvv !_HAS_WINDOWS vvv
+        // Linux uses UTF-8 everywhere, so code_page::acp is the same as code_page::utf8
+        (void) _Cp;
+#endif // _HAS_WINDOWS
+        return _Utf_to_utf8_string(_Input, "_Convert_wide_to_narrow");
+    }
 
-        string _Output;
-        const int _Input_size  = static_cast<int>(_Input.size());
-        const int _Output_size = _Input_size;
+    return string();
+}
 
-        // The WideCharToMultiByte() replaces multi byte to wide characters.
-        // _Output size must be same as _Input size.
-        _Output.resize(_Output_size, ' ');
-        if (!WideCharToMultiByte(static_cast<uint32_t>(_Cp), WC_ERR_INVALID_CHARS,
-            _Input.data(), _Input_size, _Output.data(), _Output_size, nullptr, nullptr)) { 
-            _Throw_system_error("_Convert_wide_to_narrow", "conversion failed", error_type::runtime_error);
+_NODISCARD size_t _Convert_wide_to_narrow(const code_page _Cp, const wstring_view _Input, const span<char> _Output) {
+    if (_Input.empty()) {
+        return 0;
+    }
+
+#if _HAS_WINDOWS
+    if (_Cp == code_page::acp) { // the ANSI code page depends on the system, let Windows convert it
+        if (_Input.size() > static_cast<size_t>(INT_MAX)) { // limited by the Windows API
+            _Throw_system_error("_Convert_wide_to_narrow", "invalid length", error_type::length_error);
         }
 
-        if (_Output.size() > _Input.size()) { // additional characters
-            _Output.resize(_Output_size);
+        const int _Count{WideCharToMultiByte(static_cast<uint32_t>(_Cp), 0, _Input.data(),
+            static_cast<int>(_Input.size()), _Output.data(), static_cast<int>((_STD min)(_Output.size(),
+            static_cast<size_t>(INT_MAX))), nullptr, nullptr)};
+        if (_Count == 0) {
+            _Throw_system_error("_Convert_wide_to_narrow", "conversion failed", error_type::runtime_error);
         }
 
-        return _Output;
+        return static_cast<size_t>(_Count);
+    }
+#else // ^^^ _HAS_WINDOWS ^^^ / vvv !_HAS_WINDOWS vvv
+    (void) _Cp;
+#endif // _HAS_WINDOWS
+    constexpr size_t _Max_bytes = sizeof(wchar_t) == 2 ? 3 : 4; // the worst case per code unit
+    if (_Output.size() / _Max_bytes < _Input.size() && _Output.size() < _Utf8_length(_Input)) { // measure if needed
+        _Throw_system_error("_Convert_wide_to_narrow", "buffer too small", error_type::length_error);
     }
 
-    return string();
+    const size_t _Count{_Utf_to_utf8(_Input.data(), _Input.size(), _Output.data(), true)};
+    if (_Count == _Transcode_error) {
+        _Throw_system_error("_Convert_wide_to_narrow", "conversion failed", error_type::runtime_error);
+    }
+
+    return _Count;
 }
 
 // FUNCTION TEMPLATE _Convert_utf_to_wide
 template <class _Elem, class _Traits>
-_NODISCARD constexpr string _Convert_utf_to_narrow(const basic_string_view<_Elem, _Traits> _Input) noexcept(_Is_narrow_char_t<_Elem>) {
+_NODISCARD string _Convert_utf_to_narrow(const basic_string_view<_Elem, _Traits> _Input) noexcept(_Is_narrow_char_t<_Elem>) {
     if (!_Input.empty()) {
-        if (_Input.size() > static_cast<size_t>(INT_MAX)) {
-            _Throw_system_error("_Convert_utf_to_wide", "invalid length", error_type::length_error);
-        }
-
         // check that _Elem is the default character types
         if constexpr (_Is_narrow_char_t<_Elem>) {
             return string(_Input);
         } else if constexpr (_STD is_same_v<_Elem, wchar_t>) {
             return _Convert_wide_to_narrow(code_page::utf8, _Input);
-        }
+        } else if constexpr (_STD is_same_v<_Elem, char8_t>) { // from char8_t (both are UTF-8, copy valid bytes)
+            const string_view _Bytes{reinterpret_cast<const char*>(_Input.data()), _Input.size()};
+            if (!is_valid_utf8(_Bytes)) {
+                _Throw_system_error("_Convert_utf_to_narrow", "conversion failed", error_type::runtime_error);
+            }
 
-        string _Output;
-        _Output.reserve(_Input.size()); // reserve place for new data
-
-        // If _Elem isn't char or wchar_t, use wstring_convert,
-        // instead of Windows functions (MultiByteToWideChar() and WideCharToMultiByte()).
-        if constexpr (_STD is_same_v<_Elem, char8_t>) { // from char8_t
-            _Output = wstring_convert<codecvt_utf8<char8_t>, char8_t>().to_bytes(_Input.data());
-        } else if constexpr (_STD is_same_v<_Elem, char16_t>) { // from char16_t
-            _Output = wstring_convert<codecvt_utf8_utf16<char16_t>, char16_t>().to_bytes(_Input.data());
-        } else if constexpr (_STD is_same_v<_Elem, char32_t>) { // from char32_t
-            _Output = wstring_convert<codecvt_utf8<char32_t>, char32_t>().to_bytes(_Input.data());
+            return string(_Bytes);
+        } else { // from char16_t or char32_t
+            return _Utf_to_utf8_string(_Input, "_Convert_utf_to_narrow");
         }
-        
-        return _Output;
     }
 
     return string();
@@ -115,36 +529,25 @@ template _FILESYSTEM_API _NODISCARD string _Convert_utf_to_narrow(const wstring_
 
 // FUNCTION TEMPLATE _Convert_narrow_to_utf
 template <class _Elem, class _Traits, class _Alloc>
-_NODISCARD constexpr basic_string<_Elem, _Traits, _Alloc> _Convert_narrow_to_utf(
+_NODISCARD basic_string<_Elem, _Traits, _Alloc> _Convert_narrow_to_utf(
     const string_view _Input) noexcept(_Is_narrow_char_t<_Elem>) {
     using _Str_t = basic_string<_Elem, _Traits, _Alloc>;
 
     if (!_Input.empty()) {
-        if (_Input.size() > static_cast<size_t>(INT_MAX)) {
-            _Throw_system_error("_Convert_narrow_to_utf", "invalid length", error_type::runtime_error);
-        }
-
         // check that _Elem is the default character types
         if constexpr (_Is_narrow_char_t<_Elem>) {
             return string(_Input);
         } else if constexpr (_STD is_same_v<_Elem, wchar_t>) {
             return _Convert_narrow_to_wide(code_page::utf8, _Input);
-        }
-
-        _Str_t _Output;
-        _Output.reserve(_Input.size()); // reserve place for new data
+        } else if constexpr (_STD is_same_v<_Elem, char8_t>) { // to char8_t (both are UTF-8, copy valid bytes)
+            if (!is_valid_utf8(_Input)) {
+                _Throw_system_error("_Convert_narrow_to_utf", "conversion failed", error_type::runtime_error);
+            }
 
-        // If _Elem isn't char or wchar_t, use wstring_convert,
-        // instead of Windows functions (MultiByteToWideChar() and WideCharToMultiByte()).
-        if constexpr (_STD is_same_v<_Elem, char8_t>) { // to char8_t
-            _Output = wstring_convert<codecvt_utf8<char8_t>, char8_t>().from_bytes(_Input.data());
-        } else if constexpr (_STD is_same_v<_Elem, char16_t>) { // to char16_t
-            _Output = wstring_convert<codecvt_utf8_utf16<char16_t>, char16_t>().from_bytes(_Input.data());
-        } else if constexpr (_STD is_same_v<_Elem, char32_t>) { // to char32_t
-            _Output = wstring_convert<codecvt_utf8<char32_t>, char32_t>().from_bytes(_Input.data());
+            return _Str_t(reinterpret_cast<const char8_t*>(_Input.data()), _Input.size());
+        } else { // to char16_t or char32_t
+            return _Utf8_to_utf_string<_Elem, _Traits, _Alloc>(_Input, "_Convert_narrow_to_utf");
         }
-
-        return _Output;
     }
 
     return _Str_t();
@@ -160,7 +563,7 @@ template _FILESYSTEM_API _NODISCARD wstring _Convert_narrow_to_utf(const string_
 
 // FUNCTION TEMPLATE _Convert_to_narrow
 template <class _Elem, class _Traits>
-_NODISCARD constexpr string _Convert_to_narrow(const basic_string_view<_Elem, _Traits> _Input) noexcept(_Is_narrow_char_t<_Elem>) {
+_NODISCARD string _Convert_to_narrow(const basic_string_view<_Elem, _Traits> _Input) noexcept(_Is_narrow_char_t<_Elem>) {
     if constexpr (_Is_narrow_char_t<_Elem>) {
         return string(_Input);
     } else if constexpr (_STD is_same_v<_Elem, wchar_t>) {
@@ -177,7 +580,96 @@ template _FILESYSTEM_API _NODISCARD string _Convert_to_narrow(const u8string_vie
 template _FILESYSTEM_API _NODISCARD string _Convert_to_narrow(const u16string_view);
 template _FILESYSTEM_API _NODISCARD string _Convert_to_narrow(const u32string_view);
 template _FILESYSTEM_API _NODISCARD string _Convert_to_narrow(const wstring_view);
-_FILESYSTEM_END
 
-#pragma warning(pop)
-#endif // !_HAS_WINDOWS
\ No newline at end of file
+// FUNCTION is_valid_utf8
+_NODISCARD bool is_valid_utf8(const string_view _Input) noexcept {
+    const unsigned char* const _Src{reinterpret_cast<const unsigned char*>(_Input.data())};
+    const size_t _Size{_Input.size()};
+    size_t _In{0};
+#if _FILESYSTEM_SSE2
+    size_t _Scalar_end{0}; // end of the last block that failed the vector loop
+#endif // _FILESYSTEM_SSE2
+    while (_In < _Size) {
+#if _FILESYSTEM_SSE2
+        if (_In >= _Scalar_end) { // vector loop, unless inside a block that already failed it
+            // ASCII is always valid, skip 32 bytes at a time until the first byte with the high bit set
+            while (_Size - _In >= 32) {
+                const __m128i _Low{_mm_loadu_si128(reinterpret_cast<const __m128i*>(_Src + _In))};
+                const __m128i _High{_mm_loadu_si128(reinterpret_cast<const __m128i*>(_Src + _In + 16))};
+                if (_mm_movemask_epi8(_mm_or_si128(_Low, _High)) != 0) {
+                    break;
+                }
+
+                _In += 32;
+            }
+
+            if (_In == _Size) {
+                break;
+            }
+
+            _Scalar_end = _In + 32; // finish this mixed block without retrying the vector loop
+        }
+#endif // _FILESYSTEM_SSE2
+
+        // well-formed byte sequences (Unicode Standard, table 3-7), no decoding needed
+        const unsigned char _Lead{_Src[_In]};
+        if (_Lead < 0x80) { // ASCII character
+            ++_In;
+            continue;
+        }
+
+        const size_t _Left{_Size - _In};
+        if (_Lead >= 0xC2 && _Lead <= 0xDF) { // 2 bytes
+            if (_Left < 2 || (_Src[_In + 1] & 0xC0) != 0x80) {
+                return false;
+            }
+
+            _In += 2;
+        } else if (_Lead >= 0xE0 && _Lead <= 0xEF) { // 3 bytes, E0 rejects overlong forms, ED rejects surrogates
+            const unsigned char _Min{static_cast<unsigned char>(_Lead == 0xE0 ? 0xA0 : 0x80)};
+            const unsigned char _Max{static_cast<unsigned char>(_Lead == 0xED ? 0x9F : 0xBF)};
+            if (_Left < 3 || _Src[_In + 1] < _Min || _Src[_In + 1] > _Max || (_Src[_In + 2] & 0xC0) != 0x80) {
+                return false;
+            }
+
+            _In += 3;
+        } else if (_Lead >= 0xF0 && _Lead <= 0xF4) { // 4 bytes, F0 rejects overlong forms, F4 limits to U+10FFFF
+            const unsigned char _Min{static_cast<unsigned char>(_Lead == 0xF0 ? 0x90 : 0x80)};
+            const unsigned char _Max{static_cast<unsigned char>(_Lead == 0xF4 ? 0x8F : 0xBF)};
+            if (_Left < 4 || _Src[_In + 1] < _Min || _Src[_In + 1] > _Max || (_Src[_In + 2] & 0xC0) != 0x80
+                || (_Src[_In + 3] & 0xC0) != 0x80) {
+                return false;
+            }
+
+            _In += 4;
+        } else { // continuation byte, overlong 2-byte lead (C0, C1) or lead above U+10FFFF
+            return false;
+        }
+    }
+
+    return true;
+}
+
+// FUNCTION utf8_length_of
+_NODISCARD size_t utf8_length_of(const u16string_view _Input) noexcept {
+    return _Utf8_length(_Input);
+}
+
+_NODISCARD size_t utf8_length_of(const u32string_view _Input) noexcept {
+    return _Utf8_length(_Input);
+}
+
+_NODISCARD size_t utf8_length_of(const wstring_view _Input) noexcept {
+    return _Utf8_length(_Input);
+}
+
+// FUNCTION utf16_length_of
+_NODISCARD size_t utf16_length_of(const string_view _Input) noexcept {
+    return _Utf_length<char16_t>(_Input);
+}
+
+// FUNCTION utf32_length_of
+_NODISCARD size_t utf32_length_of(const string_view _Input) noexcept {
+    return _Utf_length<char32_t>(_Input);
+}
+_FILESYSTEM_END
\ No newline at end of file
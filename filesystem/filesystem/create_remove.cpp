@@ -6,11 +6,163 @@
 #include <filesystem_pch.hpp>
 #include <filesystem.hpp>
 
+_FILESYSTEM_BEGIN
 #if !_HAS_WINDOWS
-#pragma message("The contents of <create_remove.cpp> are available only with Windows 10.")
-#else // ^^^ !_HAS_WINDOWS ^^^ / vvv _HAS_WINDOWS vvv
+// FUNCTION _Copy_regular_file
+_NODISCARD bool _Copy_regular_file(const int _Src_dir, const char* const _Src_name,
+    const int _Dest_dir, const char* const _Dest_name, const bool _Fail_if_exists) noexcept {
+    const _Unique_descriptor _Src{::openat(_Src_dir, _Src_name, O_RDONLY | O_CLOEXEC)};
+    struct stat _Stat;
+    if (_Src._Get() == -1 || ::fstat(_Src._Get(), &_Stat) != 0) {
+        return false;
+    }
+
+    const _Unique_descriptor _Dest{::openat(_Dest_dir, _Dest_name,
+        O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC | (_Fail_if_exists ? O_EXCL : 0), _Stat.st_mode & 07777)};
+    if (_Dest._Get() == -1) {
+        return false;
+    }
+
+    // copy_file_range() copies inside the kernel (or even shares extents),
+    // fall back to read()/write() if file systems don't support it
+    for (;;) {
+        const ssize_t _Copied{::copy_file_range(_Src._Get(), nullptr, _Dest._Get(), nullptr, 1 << 30, 0)};
+        if (_Copied == 0) { // end of the file
+            return true;
+        }
+
+        if (_Copied < 0) {
+            if (errno == EXDEV || errno == EINVAL || errno == ENOSYS || errno == EOPNOTSUPP) {
+                break;
+            }
+
+            return false;
+        }
+    }
+
+    char _Buff[65536];
+    for (;;) {
+        const ssize_t _Read{::read(_Src._Get(), _Buff, sizeof(_Buff))};
+        if (_Read == 0) { // end of the file
+            return true;
+        }
+
+        if (_Read < 0) {
+            return false;
+        }
+
+        for (ssize_t _Written = 0; _Written < _Read;) {
+            const ssize_t _Count{::write(_Dest._Get(), _Buff + _Written, static_cast<size_t>(_Read - _Written))};
+            if (_Count < 0) {
+                return false;
+            }
+
+            _Written += _Count;
+        }
+    }
+}
+
+// FUNCTION _Copy_directory
+_NODISCARD bool _Copy_directory(const int _Src, const int _Dest_dir, const char* const _Dest_name) {
+    // _Src is an opened directory, _Dest_name is created (or merged if exists) inside _Dest_dir
+    struct stat _Stat;
+    if (::fstat(_Src, &_Stat) != 0 || (::mkdirat(_Dest_dir, _Dest_name, _Stat.st_mode & 07777) != 0 && errno != EEXIST)) {
+        return false;
+    }
+
+    const _Unique_descriptor _Dest{_Open_directory(_Dest_dir, _Dest_name)};
+    if (_Dest._Get() == -1) {
+        return false;
+    }
+
+    _Directory_reader _Reader{_Src};
+    while (const _Linux_dirent64* const _Entry = _Reader._Next()) {
+        mode_t _Mode{static_cast<mode_t>(DTTOIF(_Entry->_Type))};
+        if (_Entry->_Type == DT_UNKNOWN) { // some file systems don't fill d_type
+            if (::fstatat(_Src, _Entry->_Name, &_Stat, AT_SYMLINK_NOFOLLOW) != 0) {
+                return false;
+            }
+
+            _Mode = _Stat.st_mode;
+        }
+
+        switch (_Mode & S_IFMT) {
+        case S_IFDIR:
+        {
+            const _Unique_descriptor _Subdir{_Open_directory(_Src, _Entry->_Name)};
+            if (_Subdir._Get() == -1 || !_Copy_directory(_Subdir._Get(), _Dest._Get(), _Entry->_Name)) {
+                return false;
+            }
+
+            break;
+        }
+        case S_IFLNK: // copy the link, not its target
+        {
+            char _Target[PATH_MAX];
+            const ssize_t _Size{::readlinkat(_Src, _Entry->_Name, _Target, sizeof(_Target) - 1)};
+            if (_Size < 0) {
+                return false;
+            }
+
+            _Target[_Size] = '\0';
+            if (::symlinkat(_Target, _Dest._Get(), _Entry->_Name) != 0) {
+                return false;
+            }
+
+            break;
+        }
+        case S_IFREG:
+            if (!_Copy_regular_file(_Src, _Entry->_Name, _Dest._Get(), _Entry->_Name, false)) {
+                return false;
+            }
+
+            break;
+        default: // devices, pipes and sockets can't be copied
+            break;
+        }
+    }
+
+    return true;
+}
+
+// FUNCTION _Copy_directory_at
+_NODISCARD bool _Copy_directory_at(const path& _From, const path& _To) {
+    // the source may be a symbolic link to directory, so follow it here
+    const _Unique_descriptor _Src{::open(_From.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC)};
+    return _Src._Get() != -1 && _Copy_directory(_Src._Get(), AT_FDCWD, _To.c_str());
+}
+
+// FUNCTION _Remove_all
+_NODISCARD bool _Remove_all(const int _Dirfd, const char* const _Name) {
+    {
+        const _Unique_descriptor _Dir{_Open_directory(_Dirfd, _Name)};
+        if (_Dir._Get() == -1) {
+            return false;
+        }
+
+        _Directory_reader _Reader{_Dir._Get()};
+        while (const _Linux_dirent64* const _Entry = _Reader._Next()) {
+            bool _Is_dir{_Entry->_Type == DT_DIR};
+            if (_Entry->_Type == DT_UNKNOWN) { // some file systems don't fill d_type
+                struct stat _Stat;
+                if (::fstatat(_Dir._Get(), _Entry->_Name, &_Stat, AT_SYMLINK_NOFOLLOW) != 0) {
+                    return false;
+                }
+
+                _Is_dir = S_ISDIR(_Stat.st_mode);
+            }
+
+            // symbolic links are removed, never followed
+            if (_Is_dir ? !_Remove_all(_Dir._Get(), _Entry->_Name) : ::unlinkat(_Dir._Get(), _Entry->_Name, 0) != 0) {
+                return false;
+            }
+        }
+    } // close the directory before removing it
+
+    return ::unlinkat(_Dirfd, _Name, AT_REMOVEDIR) == 0;
+}
+#endif // !_HAS_WINDOWS
 
-_FILESYSTEM_BEGIN
 // FUNCTION copy
 _NODISCARD bool copy(const path& _From, const path& _To, const copy_options _Options) {
     // should be checked before any operation
@@ -22,7 +174,8 @@ _NODISCARD bool copy(const path& _From, const path& _To, const copy_options _Opt
     _FILESYSTEM_VERIFY((_Options & copy_options::cannot_be_link) == copy_options::cannot_be_link
         && (is_junction(_From) || is_symlink(_From)), "target is a link", error_type::runtime_error);
     if (_Options == copy_options::none) { // try to do it with default CopyFileW() or SHFileOperationW()
-        if (!CopyFileW(_From.generic_wstring().c_str(), _To.generic_wstring().c_str(), true)) { // failed to copy target
+#if _HAS_WINDOWS
+        if (!CopyFileW(_From.c_str(), _To.c_str(), true)) { // failed to copy target
             if (GetLastError() == ERROR_ACCESS_DENIED) { // _From is directory
                 const auto& _Src  = _From.generic_wstring();
                 const auto& _Dest = _To.generic_wstring();
@@ -41,6 +194,14 @@ _NODISCARD bool copy(const path& _From, const path& _To, const copy_options _Opt
                 _Throw_fs_error("failed to copy file", error_type::runtime_error, "copy");
             }
         }
+#else // ^^^ _HAS_WINDOWS ^^^ / vvv !_HAS_WINDOWS vvv
+        if (_Is_directory(_From)) {
+            _FILESYSTEM_VERIFY(_Copy_directory_at(_From, _To), "failed to copy the directory", error_type::runtime_error);
+        } else {
+            _FILESYSTEM_VERIFY(_Copy_regular_file(AT_FDCWD, _From.c_str(), AT_FDCWD,
+                _To.c_str(), true), "failed to copy file", error_type::runtime_error);
+        }
+#endif // _HAS_WINDOWS
 
         return true;
     }
@@ -105,7 +266,7 @@ _NODISCARD bool copy(const path& _From, const path& _To, const copy_options _Opt
         if ((_Options & copy_options::replace) == copy_options::replace
             && exists(_To)) { // remove existing and copy from source to target
             (void) remove_all(_To); // remove _To as well
-
+#if _HAS_WINDOWS
             const auto& _Src  = _From.generic_wstring();
             const auto& _Dest = _To.generic_wstring();
 
@@ -119,6 +280,9 @@ _NODISCARD bool copy(const path& _From, const path& _To, const copy_options _Opt
             _Ops.pTo             = _Dest.c_str();
             _Ops.wFunc           = FO_COPY;
             _FILESYSTEM_VERIFY(SHFileOperationW(&_Ops) == 0, "failed to copy the directory", error_type::runtime_error);
+#else // ^^^ _HAS_WINDOWS ^^^ / vvv !_HAS_WINDOWS vvv
+            _FILESYSTEM_VERIFY(_Copy_directory_at(_From, _To), "failed to copy the directory", error_type::runtime_error);
+#endif // _HAS_WINDOWS
             return true;
         }
 
@@ -184,8 +348,13 @@ _NODISCARD bool copy(const path& _From, const path& _To, const copy_options _Opt
         }
 
         if ((_Options & copy_options::replace) == copy_options::replace && exists(_To)) { // remove old file and copy from source path
-            _FILESYSTEM_VERIFY(CopyFileW(_From.generic_wstring().c_str(), _To.generic_wstring().c_str(),
+#if _HAS_WINDOWS
+            _FILESYSTEM_VERIFY(CopyFileW(_From.c_str(), _To.c_str(),
                 false), "failed to copy the file", error_type::runtime_error);
+#else // ^^^ _HAS_WINDOWS ^^^ / vvv !_HAS_WINDOWS vvv
+            _FILESYSTEM_VERIFY(_Copy_regular_file(AT_FDCWD, _From.c_str(), AT_FDCWD,
+                _To.c_str(), false), "failed to copy the file", error_type::runtime_error);
+#endif // _HAS_WINDOWS
             return true;
         }
 
@@ -252,20 +421,32 @@ _NODISCARD bool copy_symlink(const path& _Symlink, const path& _Newsymlink) {
 
 // FUNCTION create_directory
 _NODISCARD bool create_directory(const path& _Path) {
-    _FILESYSTEM_VERIFY(CreateDirectoryW(_Path.generic_wstring().c_str(), nullptr),
+#if _HAS_WINDOWS
+    _FILESYSTEM_VERIFY(CreateDirectoryW(_Path.c_str(), nullptr),
+        "failed to create the directory", error_type::runtime_error);
+#else // ^^^ _HAS_WINDOWS ^^^ / vvv !_HAS_WINDOWS vvv
+    _FILESYSTEM_VERIFY(::mkdir(_Path.c_str(), 0777) == 0,
         "failed to create the directory", error_type::runtime_error);
+#endif // _HAS_WINDOWS
     return true;
 }
 
 // FUNCTION create_file
 _NODISCARD bool create_file(const path& _Path, const file_attributes _Attributes) {
     _FILESYSTEM_VERIFY(!exists(_Path), "file already exists", error_type::runtime_error);
-    const HANDLE _Handle{CreateFileW(_Path.generic_wstring().c_str(),
+#if _HAS_WINDOWS
+    const HANDLE _Handle{CreateFileW(_Path.c_str(),
         static_cast<unsigned long>(file_access::all), static_cast<unsigned long>(file_share::all),
         nullptr, static_cast<unsigned long>(file_disposition::only_new), static_cast<unsigned long>(_Attributes), nullptr)};
     _FILESYSTEM_VERIFY_HANDLE(_Handle);
 
     CloseHandle(_Handle);
+#else // ^^^ _HAS_WINDOWS ^^^ / vvv !_HAS_WINDOWS vvv
+    // only file_attributes::readonly can be represented on Linux, others are ignored
+    const mode_t _Mode{(_Attributes & file_attributes::readonly) == file_attributes::readonly ? 0444u : 0666u};
+    const _Unique_descriptor _Fd{::open(_Path.c_str(), O_WRONLY | O_CREAT | O_EXCL | O_CLOEXEC, _Mode)};
+    _FILESYSTEM_VERIFY_DESCRIPTOR(_Fd._Get());
+#endif // _HAS_WINDOWS
     _FILESYSTEM_VERIFY(exists(_Path), "failed to create the file", error_type::runtime_error);
     return true;
 }
@@ -276,21 +457,29 @@ _NODISCARD bool create_file(const path& _Path) { // creates new file
 
 // FUNCTION create_hard_link
 _NODISCARD bool create_hard_link(const path& _To, const path& _Hardlink) { // creates hard link _Hardlink to _To
-    _FILESYSTEM_VERIFY(CreateHardLinkW(_Hardlink.generic_wstring().c_str(), _To.generic_wstring().c_str(),
+#if _HAS_WINDOWS
+    _FILESYSTEM_VERIFY(CreateHardLinkW(_Hardlink.c_str(), _To.c_str(),
         nullptr), "failed to create the hard link", error_type::runtime_error);
+#else // ^^^ _HAS_WINDOWS ^^^ / vvv !_HAS_WINDOWS vvv
+    _FILESYSTEM_VERIFY(::link(_To.c_str(), _Hardlink.c_str()) == 0,
+        "failed to create the hard link", error_type::runtime_error);
+#endif // _HAS_WINDOWS
     return true;
 }
 
+#if _HAS_WINDOWS
 #pragma warning(push)
 #pragma warning(disable : 6385) // C6385: reading incorrect data
+#endif // _HAS_WINDOWS
 // FUNCTION create_junction
 _NODISCARD bool create_junction(const path& _To, const path& _Junction) {
     _FILESYSTEM_VERIFY(exists(_To), "directory not found", error_type::runtime_error);
     _FILESYSTEM_VERIFY(is_directory(_To), "expected a directory", error_type::runtime_error);
+#if _HAS_WINDOWS
 
     // at the beginning _Junction must be created as default directory 
     (void) create_directory(_Junction);
-    const HANDLE _Handle{CreateFileW(_Junction.generic_wstring().c_str(),
+    const HANDLE _Handle{CreateFileW(_Junction.c_str(),
         static_cast<unsigned long>(file_access::readonly | file_access::writeonly), 0, nullptr,
         static_cast<unsigned long>(file_disposition::only_if_exists), static_cast<unsigned long>(
             file_flags::backup_semantics | file_flags::open_reparse_point), nullptr)};
@@ -319,7 +508,13 @@ _NODISCARD bool create_junction(const path& _To, const path& _Junction) {
     CloseHandle(_Handle);
     _FILESYSTEM_VERIFY(is_junction(_Junction), "failed to create the junction", error_type::runtime_error);
     return true;
+#else // ^^^ _HAS_WINDOWS ^^^ / vvv !_HAS_WINDOWS vvv
+    // junctions are NTFS reparse points, Linux has nothing similar (use create_symlink() instead)
+    (void) _Junction;
+    _Throw_fs_error("operation not supported", error_type::invalid_argument, "create_junction");
+#endif // _HAS_WINDOWS
 }
+#if _HAS_WINDOWS
 #pragma warning(pop)
 
 namespace experimental {
@@ -336,7 +531,7 @@ namespace experimental {
         _FILESYSTEM_VERIFY(CoInitialize(nullptr) == S_OK, "failed to initialize COM library", error_type::runtime_error);
         _FILESYSTEM_VERIFY(CoCreateInstance(CLSID_ShellLink, nullptr, CLSCTX_ALL, IID_IShellLinkW,
             reinterpret_cast<void**>(&_Link)) == S_OK, "failed to create COM object instance", error_type::runtime_error);
-        _FILESYSTEM_VERIFY_COM_RESULT(_Link->SetPath(_To.generic_wstring().c_str()), _Link);
+        _FILESYSTEM_VERIFY_COM_RESULT(_Link->SetPath(_To.c_str()), _Link);
 #ifndef _FILESYSTEM_DEPRECATED_SHORTCUT_PARAMETERS
         // Current version don't offerts conversion between char[16/32]_t and wchar_t.
         // First convert to narrow, and then from narrow to wide.
@@ -346,7 +541,7 @@ namespace experimental {
 #endif // _FILESYSTEM_DEPRECATED_SHORTCUT_PARAMETERS
         IPersistFile* _File = {};
         _FILESYSTEM_VERIFY_COM_RESULT(_Link->QueryInterface(IID_IPersistFile, reinterpret_cast<void**>(&_File)), _Link);
-        _FILESYSTEM_VERIFY_COM_RESULT(_File->Save(_Shortcut.generic_wstring().c_str(), true), _Link);
+        _FILESYSTEM_VERIFY_COM_RESULT(_File->Save(_Shortcut.c_str(), true), _Link);
         _File->Release();
         _Link->Release();
         return true;
@@ -360,11 +555,18 @@ namespace experimental {
     template _FILESYSTEM_API _NODISCARD bool create_shortcut(const path&, const path&, const wchar_t* const);
 #endif // _FILESYSTEM_DEPRECATED_SHORTCUT_PARAMETERS
 } // experimental
+#endif // _HAS_WINDOWS
 
 // FUNCTION create_symlink
 _NODISCARD bool create_symlink(const path& _To, const path& _Symlink, const symlink_flags _Flags) {
-    _FILESYSTEM_VERIFY(CreateSymbolicLinkW(_Symlink.generic_wstring().c_str(), _To.generic_wstring().c_str(),
+#if _HAS_WINDOWS
+    _FILESYSTEM_VERIFY(CreateSymbolicLinkW(_Symlink.c_str(), _To.c_str(),
         static_cast<unsigned long>(_Flags)), "failed to create the symlink", error_type::runtime_error);
+#else // ^^^ _HAS_WINDOWS ^^^ / vvv !_HAS_WINDOWS vvv
+    (void) _Flags; // Linux symbolic links don't depend on the target type or privileges
+    _FILESYSTEM_VERIFY(::symlink(_To.c_str(), _Symlink.c_str()) == 0,
+        "failed to create the symlink", error_type::runtime_error);
+#endif // _HAS_WINDOWS
     return true;
 }
 
@@ -375,8 +577,14 @@ _NODISCARD bool create_symlink(const path& _To, const path& _Symlink) {
 
 // FUNCTION remove
 _NODISCARD bool remove(const path& _Path) { // removes files and directories
-    _FILESYSTEM_VERIFY(_Is_directory(_Path) ? RemoveDirectoryW(_Path.generic_wstring().c_str())
-        : DeleteFileW(_Path.generic_wstring().c_str()), "failed to remove the target", error_type::runtime_error);
+#if _HAS_WINDOWS
+    _FILESYSTEM_VERIFY(_Is_directory(_Path) ? RemoveDirectoryW(_Path.c_str())
+        : DeleteFileW(_Path.c_str()), "failed to remove the target", error_type::runtime_error);
+#else // ^^^ _HAS_WINDOWS ^^^ / vvv !_HAS_WINDOWS vvv
+    // symbolic link to directory is removed like a file
+    _FILESYSTEM_VERIFY(::unlinkat(AT_FDCWD, _Path.c_str(), is_directory(_Path) ? AT_REMOVEDIR : 0) == 0,
+        "failed to remove the target", error_type::runtime_error);
+#endif // _HAS_WINDOWS
     return true;
 }
 
@@ -387,6 +595,7 @@ _NODISCARD bool remove_all(const path& _Path) { // removes directory with all co
         return remove(_Path);
     }
 
+#if _HAS_WINDOWS
     const auto& _Src{_Path.generic_wstring()};
     if (_Src.back() != _Expected_slash) { // must contains slash before null-char
         const_cast<wstring&>(_Src).push_back(static_cast<wchar_t>(_Expected_slash));
@@ -410,13 +619,22 @@ _NODISCARD bool remove_all(const path& _Path) { // removes directory with all co
     _FILESYSTEM_VERIFY(SHFileOperationW(&_Ops) == 0, "failed to remove the directory", error_type::runtime_error);
 
     // SHFileOperationW() removes base directory as well, so there's nothing to do more
+#else // ^^^ _HAS_WINDOWS ^^^ / vvv !_HAS_WINDOWS vvv
+    if (is_symlink(_Path)) { // remove the link, not the content of its target
+        return remove(_Path);
+    }
+
+    _FILESYSTEM_VERIFY(_Remove_all(AT_FDCWD, _Path.c_str()),
+        "failed to remove the directory", error_type::runtime_error);
+#endif // _HAS_WINDOWS
     return true;
 }
 
 // FUNCTION remove_junction
 _NODISCARD bool remove_junction(const path& _Target) {
     _FILESYSTEM_VERIFY(is_junction(_Target), "expected a junction", error_type::runtime_error);
-    const HANDLE _Handle{CreateFileW(_Target.generic_wstring().c_str(),
+#if _HAS_WINDOWS
+    const HANDLE _Handle{CreateFileW(_Target.c_str(),
         static_cast<unsigned long>(file_access::readonly | file_access::writeonly), 0, nullptr,
         static_cast<unsigned long>(file_disposition::only_if_exists), static_cast<unsigned long>(
             file_flags::backup_semantics | file_flags::open_reparse_point), nullptr)};
@@ -436,6 +654,7 @@ _NODISCARD bool remove_junction(const path& _Target) {
     }
 
     CloseHandle(_Handle);
+#endif // _HAS_WINDOWS
     return true;
 }
 
@@ -476,14 +695,41 @@ _NODISCARD bool remove_lines(const path& _Target, const uintmax_t _First, uintma
 
 // FUNCTION rename
 _NODISCARD bool rename(const path& _Old, const path& _New, const rename_options _Flags) { // renames _Old to _New
-    _FILESYSTEM_VERIFY(MoveFileExW(_Old.generic_wstring().c_str(), _New.generic_wstring().c_str(),
+#if _HAS_WINDOWS
+    _FILESYSTEM_VERIFY(MoveFileExW(_Old.c_str(), _New.c_str(),
         static_cast<unsigned long>(_Flags)), "failed to rename the target", error_type::runtime_error);
+#else // ^^^ _HAS_WINDOWS ^^^ / vvv !_HAS_WINDOWS vvv
+    const bool _Replace{(_Flags & rename_options::replace) == rename_options::replace};
+    int _Result{::renameat2(AT_FDCWD, _Old.c_str(), AT_FDCWD, _New.c_str(), _Replace ? 0 : RENAME_NOREPLACE)};
+    if (_Result != 0 && errno == EINVAL && !_Replace) {
+        // some file systems (older NFS, FUSE) don't support RENAME_NOREPLACE, check the target by hand
+        struct stat _Stat;
+        _FILESYSTEM_VERIFY(::lstat(_New.c_str(), &_Stat) != 0 && errno == ENOENT,
+            "failed to rename the target", error_type::runtime_error);
+        _Result = ::renameat(AT_FDCWD, _Old.c_str(), AT_FDCWD, _New.c_str());
+    }
+
+    if (_Result != 0) {
+        // rename() can't move between file systems, copy and remove if it's allowed
+        _FILESYSTEM_VERIFY(errno == EXDEV && (_Flags & rename_options::copy) == rename_options::copy,
+            "failed to rename the target", error_type::runtime_error);
+        const bool _Directory{is_directory(_Old)};
+        _FILESYSTEM_VERIFY(_Directory ? _Copy_directory_at(_Old, _New) : _Copy_regular_file(AT_FDCWD,
+            _Old.c_str(), AT_FDCWD, _New.c_str(), !_Replace),
+            "failed to rename the target", error_type::runtime_error);
+        (void) (_Directory ? remove_all(_Old) : remove(_Old));
+    }
+
+    if ((_Flags & rename_options::write_through) == rename_options::write_through) { // flush before returning
+        const _Unique_descriptor _Fd{::open(_New.c_str(), O_RDONLY | O_CLOEXEC)};
+        _FILESYSTEM_VERIFY(_Fd._Get() != -1 && ::fsync(_Fd._Get()) == 0,
+            "failed to rename the target", error_type::runtime_error);
+    }
+#endif // _HAS_WINDOWS
     return true;
 }
 
 _NODISCARD bool rename(const path& _Old, const path& _New) {
     return rename(_Old, _New, rename_options::copy | rename_options::replace);
 }
-_FILESYSTEM_END
-
-#endif // !_HAS_WINDOWS
\ No newline at end of file
+_FILESYSTEM_END
\ No newline at end of file
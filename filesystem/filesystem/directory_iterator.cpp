@@ -0,0 +1,156 @@
+// directory_iterator.cpp
+
+// Copyright (c) Mateusz Jandura. All rights reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#include <filesystem_pch.hpp>
+#include <filesystem.hpp>
+
+_FILESYSTEM_BEGIN
+// STRUCT _Directory_iterator_state
+struct _Directory_iterator_state { // the open directory and the current entry
+#if _HAS_WINDOWS
+    explicit _Directory_iterator_state(const path& _Target, const directory_options _Options)
+        : _Directory(_Target), _Handle(INVALID_HANDLE_VALUE), _Data(WIN32_FIND_DATAW()),
+        _Pending(true), _Options(_Options), _Entry() {
+        // FIND_FIRST_EX_LARGE_FETCH asks for more entries per system call
+        _Handle = FindFirstFileExW(path_builder(_Target).push("*").get().c_str(), FindExInfoBasic,
+            &_Data, FindExSearchNameMatch, nullptr, FIND_FIRST_EX_LARGE_FETCH);
+        _FILESYSTEM_VERIFY_HANDLE(_Handle);
+    }
+
+    ~_Directory_iterator_state() noexcept {
+        FindClose(_Handle);
+    }
+#else // ^^^ _HAS_WINDOWS ^^^ / vvv !_HAS_WINDOWS vvv
+    explicit _Directory_iterator_state(const path& _Target, const directory_options _Options)
+        : _Dir(::openat(AT_FDCWD, _Target.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC)), _Reader(_Dir._Get()),
+        _Options(_Options), _Entry() {
+        // _Target may be a symbolic link to directory, so follow it here, like FindFirstFileExW() does
+        _FILESYSTEM_VERIFY_DESCRIPTOR(_Dir._Get());
+    }
+#endif // _HAS_WINDOWS
+
+    _Directory_iterator_state(const _Directory_iterator_state&)            = delete;
+    _Directory_iterator_state& operator=(const _Directory_iterator_state&) = delete;
+
+    // reads the next entry into _Entry, returns false if there are no more entries
+    _NODISCARD bool _Next() {
+#if _HAS_WINDOWS
+        for (;;) {
+            if (_Pending) { // the first entry comes from FindFirstFileExW()
+                _Pending = false;
+            } else if (!FindNextFileW(_Handle, &_Data)) {
+                _FILESYSTEM_VERIFY(GetLastError() == ERROR_NO_MORE_FILES,
+                    "failed to read the directory", error_type::runtime_error);
+                return false;
+            }
+
+            const wchar_t* const _Name{_Data.cFileName};
+            if (_Name[0] == L'.' && (_Name[1] == L'\0' || (_Name[1] == L'.' && _Name[2] == L'\0'))) { // skip dots
+                continue;
+            }
+
+            _Entry.name     = _Name;
+            _Entry.type     = _File_type_from_find_data(_Data);
+            _Entry.has_info = false;
+            if ((_Options & directory_options::fetch_info) == directory_options::fetch_info) {
+                // the find data has neither the links count nor the id, so ask for everything at once
+                _TRY_BEGIN
+                _Entry.has_info = _Try_info(path_builder(_Directory).push(_Entry.name).get(), false, _Entry.info);
+                _CATCH(const filesystem_error&)
+                // e.g. ERROR_ACCESS_DENIED or ERROR_SHARING_VIOLATION, the name and the type are still valid
+                _Entry.has_info = false;
+                _CATCH_END
+            }
+
+            return true;
+        }
+#else // ^^^ _HAS_WINDOWS ^^^ / vvv !_HAS_WINDOWS vvv
+        const _Linux_dirent64* const _Raw{_Reader._Next()};
+        if (!_Raw) {
+            return false;
+        }
+
+        _Entry.name     = static_cast<const char*>(_Raw->_Name);
+        _Entry.type     = _File_type_from_dirent(_Dir._Get(), *_Raw);
+        _Entry.has_info = false;
+        if ((_Options & directory_options::fetch_info) == directory_options::fetch_info) {
+            // relative to the open directory, so the path isn't resolved again
+            _TRY_BEGIN
+            _Entry.has_info = _Try_info_at(_Dir._Get(), _Raw->_Name, false, _Entry.info);
+            _CATCH(const filesystem_error&)
+            // e.g. EACCES, the name and the type are still valid
+            _Entry.has_info = false;
+            _CATCH_END
+        }
+
+        return true;
+#endif // _HAS_WINDOWS
+    }
+
+#if _HAS_WINDOWS
+    path _Directory; // needed to build full paths for directory_options::fetch_info
+    HANDLE _Handle; // search handle
+    WIN32_FIND_DATAW _Data; // the latest entry returned by the system
+    bool _Pending; // true if _Data holds an entry that wasn't returned yet
+#else // ^^^ _HAS_WINDOWS ^^^ / vvv !_HAS_WINDOWS vvv
+    _Unique_descriptor _Dir; // the open directory
+    _Directory_reader _Reader; // reads entries of _Dir in batches
+#endif // _HAS_WINDOWS
+    directory_options _Options;
+    directory_entry _Entry; // the current entry
+};
+
+// FUNCTION directory_iterator constructors/destructor
+directory_iterator::directory_iterator() noexcept : _Mystate() {}
+
+directory_iterator::directory_iterator(const path& _Target, const directory_options _Options)
+    : _Mystate(_STD make_shared<_Directory_iterator_state>(_Target, _Options)) {
+    _Advance(); // go to the first entry
+}
+
+directory_iterator::~directory_iterator() noexcept {}
+
+// FUNCTION directory_iterator::operator*
+_NODISCARD directory_iterator::reference directory_iterator::operator*() const noexcept {
+    return _Mystate->_Entry;
+}
+
+// FUNCTION directory_iterator::operator->
+_NODISCARD directory_iterator::pointer directory_iterator::operator->() const noexcept {
+    return &_Mystate->_Entry;
+}
+
+// FUNCTION directory_iterator::operator++
+directory_iterator& directory_iterator::operator++() {
+    _Advance();
+    return *this;
+}
+
+void directory_iterator::operator++(int) {
+    _Advance();
+}
+
+// FUNCTION directory_iterator::operator==
+_NODISCARD bool directory_iterator::operator==(const directory_iterator& _Other) const noexcept {
+    return _Mystate == _Other._Mystate;
+}
+
+// FUNCTION directory_iterator::_Advance
+void directory_iterator::_Advance() {
+    if (_Mystate && !_Mystate->_Next()) { // no more entries, the directory is closed with the last reference
+        _Mystate.reset();
+    }
+}
+
+// FUNCTION begin
+_NODISCARD directory_iterator begin(directory_iterator _Iter) noexcept {
+    return _Iter;
+}
+
+// FUNCTION end
+_NODISCARD directory_iterator end(const directory_iterator&) noexcept {
+    return directory_iterator{};
+}
+_FILESYSTEM_END
\ No newline at end of file
@@ -0,0 +1,88 @@
+// directory_usage.cpp
+
+// Copyright (c) Mateusz Jandura. All rights reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#include <filesystem_pch.hpp>
+#include <filesystem.hpp>
+#include <mutex>
+#include <thread>
+#include <unordered_set>
+
+_FILESYSTEM_BEGIN
+// CONSTANT _Usage_slots
+inline constexpr size_t _Usage_slots = 16; // partial sums, each worker thread usually has its own
+
+// STRUCT _Usage_slot
+struct alignas(64) _Usage_slot { // partial sums of the threads that hash to this slot
+    _STD mutex _Mutex;
+    disk_usage _Usage{};
+};
+
+// FUNCTION _Add_usage
+void _Add_usage(disk_usage& _Usage, const walk_entry& _Entry, const path_view _Extension) {
+    _Usage.allocation_size += _Entry.info.allocation_size;
+    if (_Entry.info.type == file_type::directory || _Entry.info.type == file_type::junction) {
+        ++_Usage.directories;
+        return;
+    }
+
+    ++_Usage.files;
+    _Usage.size += _Entry.info.size;
+    auto _Found{_Usage.extensions.find(_Extension)};
+    if (_Found == _Usage.extensions.end()) { // the key is copied only once per slot
+        _Found = _Usage.extensions.emplace(path{_Extension}, extension_usage{}).first;
+    }
+
+    ++_Found->second.files;
+    _Found->second.size += _Entry.info.size;
+    _Found->second.allocation_size += _Entry.info.allocation_size;
+}
+
+// FUNCTION directory_usage
+_NODISCARD disk_usage directory_usage(const path& _Root, const size_t _Threads) {
+    _Usage_slot _Slots[_Usage_slots];
+    _STD unordered_set<file_id, _File_id_hash, _File_id_equal> _Linked; // files with more than one hard link
+    _STD mutex _Linked_mutex;
+    walk_options _Options;
+    _Options.threads           = _Threads;
+    _Options.fetch_info        = true;
+    _Options.skip_inaccessible = true; // one unreadable entry shouldn't lose the sum of everything else
+    recursive_walk(_Root, [&](const walk_entry& _Entry) {
+        if (!_Entry.has_info) { // removed while walking or inaccessible, its size is unknown
+            return walk_action::proceed;
+        }
+
+        if (_Entry.info.hard_link_count > 1 && _Entry.info.type != file_type::directory) { // count the data once
+            const _STD lock_guard<_STD mutex> _Guard(_Linked_mutex);
+            if (!_Linked.insert(_Entry.info.id).second) {
+                return walk_action::proceed;
+            }
+        }
+
+        // the hash of the thread id is computed only once per thread
+        thread_local const size_t _Slot{_STD hash<_STD thread::id>{}(_STD this_thread::get_id()) % _Usage_slots};
+        _Usage_slot& _Target{_Slots[_Slot]};
+        const _STD lock_guard<_STD mutex> _Guard(_Target._Mutex);
+        _Add_usage(_Target._Usage, _Entry, path_view{_Entry.target}.extension());
+        return walk_action::proceed;
+    }, _Options);
+
+    disk_usage _Result{};
+    for (_Usage_slot& _Slot : _Slots) { // all workers are finished, no need to lock
+        disk_usage& _Usage{_Slot._Usage};
+        _Result.size += _Usage.size;
+        _Result.allocation_size += _Usage.allocation_size;
+        _Result.files += _Usage.files;
+        _Result.directories += _Usage.directories;
+        for (auto& _Pair : _Usage.extensions) {
+            extension_usage& _Total{_Result.extensions[_Pair.first]};
+            _Total.files += _Pair.second.files;
+            _Total.size += _Pair.second.size;
+            _Total.allocation_size += _Pair.second.allocation_size;
+        }
+    }
+
+    return _Result;
+}
+_FILESYSTEM_END
\ No newline at end of file
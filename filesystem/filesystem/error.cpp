@@ -6,13 +6,10 @@
 #include <filesystem_pch.hpp>
 #include <filesystem.hpp>
 
-#if !_HAS_WINDOWS
-#pragma message("The contents of <error.cpp> are available only with Windows 10.")
-#else // ^^^ !_HAS_WINDOWS ^^^ / vvv _HAS_WINDOWS vvv
 
 _FILESYSTEM_BEGIN
 // FUNCTION _Throw_system_error
-__declspec(noreturn) void _Throw_system_error(const char* const _Src, const char* const _Msg, const error_type _Code) {
+_NORETURN void _Throw_system_error(const char* const _Src, const char* const _Msg, const error_type _Code) {
     // construct message in 'src: error' format
     string _Full_msg = _Src; // append error source
     _Full_msg       += ": ";
@@ -100,17 +97,15 @@ _NODISCARD const string& filesystem_error::what() const noexcept {
 }
 
 // FUNCTION _Throw_fs_error
-__declspec(noreturn) void _Throw_fs_error(const char* const _Msg) {
+_NORETURN void _Throw_fs_error(const char* const _Msg) {
     _THROW(filesystem_error(_Msg));
 }
 
-__declspec(noreturn) void _Throw_fs_error(const char* const _Msg, const error_type _Code) {
+_NORETURN void _Throw_fs_error(const char* const _Msg, const error_type _Code) {
     _THROW(filesystem_error(_Msg, _Code));
 }
 
-__declspec(noreturn) void _Throw_fs_error(const char* const _Msg, const error_type _Code, const path& _Src) {
+_NORETURN void _Throw_fs_error(const char* const _Msg, const error_type _Code, const path& _Src) {
     _THROW(filesystem_error(_Msg, _Code, _Src));
 }
-_FILESYSTEM_END
-
-#endif // !_HAS_WINDOWS
\ No newline at end of file
+_FILESYSTEM_END
\ No newline at end of file
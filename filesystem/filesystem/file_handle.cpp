@@ -0,0 +1,240 @@
+// file_handle.cpp
+
+// Copyright (c) Mateusz Jandura. All rights reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#include <filesystem_pch.hpp>
+#include <filesystem.hpp>
+#include <algorithm>
+#include <utility>
+
+_FILESYSTEM_BEGIN
+#if _HAS_WINDOWS
+// CONSTANT _Max_transfer
+inline constexpr size_t _Max_transfer = 0x40000000; // bytes read/written by one call, ReadFile() takes 32-bit sizes
+
+// CONSTANT _Invalid_handle
+inline const HANDLE _Invalid_handle = INVALID_HANDLE_VALUE;
+
+// FUNCTION _Overlapped_at
+_NODISCARD OVERLAPPED _Overlapped_at(const uintmax_t _Offset) noexcept {
+    // with a synchronous handle the offset is used instead of the file pointer, the pointer isn't shared
+    OVERLAPPED _Result = OVERLAPPED();
+    _Result.Offset     = static_cast<unsigned long>(_Offset);
+    _Result.OffsetHigh = static_cast<unsigned long>(_Offset >> 32);
+    return _Result;
+}
+#else // ^^^ _HAS_WINDOWS ^^^ / vvv !_HAS_WINDOWS vvv
+// CONSTANT _Invalid_handle
+inline constexpr int _Invalid_handle = -1;
+
+// FUNCTION _Open_flags
+_NODISCARD int _Open_flags(const file_access _Access, const file_disposition _Disposition) noexcept {
+    // file_access and file_disposition keep Windows values, translate them to open() flags
+    int _Flags{O_CLOEXEC};
+    const bool _Read{(_Access & file_access::readonly) == file_access::readonly};
+    const bool _Write{(_Access & file_access::writeonly) == file_access::writeonly};
+    if ((_Access & file_access::all) == file_access::all || (_Read && _Write)) {
+        _Flags |= O_RDWR;
+    } else if (_Write) {
+        _Flags |= O_WRONLY;
+    } else {
+        _Flags |= O_RDONLY;
+    }
+
+    switch (_Disposition) {
+    case file_disposition::only_new:
+        return _Flags | O_CREAT | O_EXCL;
+    case file_disposition::force_create:
+        return _Flags | O_CREAT | O_TRUNC;
+    case file_disposition::force_open:
+        return _Flags | O_CREAT;
+    default: // file_disposition::only_if_exists
+        return _Flags;
+    }
+}
+#endif // _HAS_WINDOWS
+
+// FUNCTION file_handle constructors/destructor
+file_handle::file_handle() noexcept : _Myhandle(_Invalid_handle) {}
+
+file_handle::file_handle(const path& _Target, const file_access _Access, const file_disposition _Disposition)
+    : _Myhandle(_Invalid_handle) {
+#if _HAS_WINDOWS
+    // backup semantics allow to open directories as well, their metadata can be queried the same way
+    _Myhandle = CreateFileW(_Target.c_str(), static_cast<unsigned long>(_Access),
+        static_cast<unsigned long>(file_share::all), nullptr, static_cast<unsigned long>(_Disposition),
+        static_cast<unsigned long>(file_attributes::normal) | static_cast<unsigned long>(file_flags::backup_semantics),
+        nullptr);
+    _FILESYSTEM_VERIFY_HANDLE(_Myhandle);
+#else // ^^^ _HAS_WINDOWS ^^^ / vvv !_HAS_WINDOWS vvv
+    _Myhandle = ::open(_Target.c_str(), _Open_flags(_Access, _Disposition), 0666);
+    _FILESYSTEM_VERIFY_DESCRIPTOR(_Myhandle);
+#endif // _HAS_WINDOWS
+}
+
+file_handle::file_handle(file_handle&& _Other) noexcept
+    : _Myhandle(_STD exchange(_Other._Myhandle, _Invalid_handle)) {}
+
+file_handle::~file_handle() noexcept {
+    close();
+}
+
+// FUNCTION file_handle::operator=
+file_handle& file_handle::operator=(file_handle&& _Other) noexcept {
+    if (this != &_Other) {
+        close();
+        _Myhandle = _STD exchange(_Other._Myhandle, _Invalid_handle);
+    }
+
+    return *this;
+}
+
+// FUNCTION file_handle::close
+void file_handle::close() noexcept {
+    if (is_open()) {
+#if _HAS_WINDOWS
+        CloseHandle(_Myhandle);
+#else // ^^^ _HAS_WINDOWS ^^^ / vvv !_HAS_WINDOWS vvv
+        ::close(_Myhandle);
+#endif // _HAS_WINDOWS
+        _Myhandle = _Invalid_handle;
+    }
+}
+
+// FUNCTION file_handle::info
+_NODISCARD file_info file_handle::info() const {
+    _FILESYSTEM_VERIFY(is_open(), "file is not open", error_type::runtime_error);
+    file_info _Result{};
+#if _HAS_WINDOWS
+    _FILESYSTEM_VERIFY(_Handle_info(_Myhandle, _Result), "failed to get informations", error_type::runtime_error);
+#else // ^^^ _HAS_WINDOWS ^^^ / vvv !_HAS_WINDOWS vvv
+    _FILESYSTEM_VERIFY(_Try_info_at(_Myhandle, "", true, _Result), "failed to get informations",
+        error_type::runtime_error);
+#endif // _HAS_WINDOWS
+    return _Result;
+}
+
+// FUNCTION file_handle::id
+_NODISCARD file_id file_handle::id() const {
+    return info().id;
+}
+
+// FUNCTION file_handle::is_open
+_NODISCARD bool file_handle::is_open() const noexcept {
+    return _Myhandle != _Invalid_handle;
+}
+
+// FUNCTION file_handle::link_count
+_NODISCARD uintmax_t file_handle::link_count() const {
+    return info().hard_link_count;
+}
+
+// FUNCTION file_handle::native_handle
+_NODISCARD file_handle::native_handle_type file_handle::native_handle() const noexcept {
+    return _Myhandle;
+}
+
+// FUNCTION file_handle::read_at
+_NODISCARD size_t file_handle::read_at(const uintmax_t _Offset, const span<char> _Buffer) const {
+    _FILESYSTEM_VERIFY(is_open(), "file is not open", error_type::runtime_error);
+    size_t _Total{0};
+    while (_Total < _Buffer.size()) { // the system may return less than requested, stop only at the end
+#if _HAS_WINDOWS
+        OVERLAPPED _Position{_Overlapped_at(_Offset + _Total)};
+        const unsigned long _Size{static_cast<unsigned long>((_STD min)(_Buffer.size() - _Total, _Max_transfer))};
+        unsigned long _Read{0};
+        if (!ReadFile(_Myhandle, _Buffer.data() + _Total, _Size, &_Read, &_Position)) {
+            _FILESYSTEM_VERIFY(GetLastError() == ERROR_HANDLE_EOF, "failed to read file", error_type::runtime_error);
+            break;
+        }
+#else // ^^^ _HAS_WINDOWS ^^^ / vvv !_HAS_WINDOWS vvv
+        const ssize_t _Read{::pread(_Myhandle, _Buffer.data() + _Total, _Buffer.size() - _Total,
+            static_cast<off_t>(_Offset + _Total))};
+        if (_Read < 0) {
+            _FILESYSTEM_VERIFY(errno == EINTR, "failed to read file", error_type::runtime_error);
+            continue;
+        }
+#endif // _HAS_WINDOWS
+        if (_Read == 0) { // end of the file
+            break;
+        }
+
+        _Total += static_cast<size_t>(_Read);
+    }
+
+    return _Total;
+}
+
+// FUNCTION file_handle::resize
+_NODISCARD bool file_handle::resize(const uintmax_t _Newsize) const {
+    _FILESYSTEM_VERIFY(is_open(), "file is not open", error_type::runtime_error);
+#if _HAS_WINDOWS
+    // unlike SetEndOfFile(), it doesn't need to move the file pointer
+    FILE_END_OF_FILE_INFO _End = FILE_END_OF_FILE_INFO();
+    _End.EndOfFile.QuadPart    = static_cast<long long>(_Newsize);
+    _FILESYSTEM_VERIFY(SetFileInformationByHandle(_Myhandle, FileEndOfFileInfo, &_End, sizeof(_End)),
+        "failed to resize file", error_type::runtime_error);
+#else // ^^^ _HAS_WINDOWS ^^^ / vvv !_HAS_WINDOWS vvv
+    _FILESYSTEM_VERIFY(::ftruncate(_Myhandle, static_cast<off_t>(_Newsize)) == 0,
+        "failed to resize file", error_type::runtime_error);
+#endif // _HAS_WINDOWS
+    return true;
+}
+
+// FUNCTION file_handle::size
+_NODISCARD uintmax_t file_handle::size() const {
+    _FILESYSTEM_VERIFY(is_open(), "file is not open", error_type::runtime_error);
+#if _HAS_WINDOWS
+    LARGE_INTEGER _Size = LARGE_INTEGER();
+    _FILESYSTEM_VERIFY(GetFileSizeEx(_Myhandle, &_Size), "failed to get file size", error_type::runtime_error);
+    return static_cast<uintmax_t>(_Size.QuadPart);
+#else // ^^^ _HAS_WINDOWS ^^^ / vvv !_HAS_WINDOWS vvv
+    struct stat _Stat;
+    _FILESYSTEM_VERIFY(::fstat(_Myhandle, &_Stat) == 0, "failed to get file size", error_type::runtime_error);
+    return static_cast<uintmax_t>(_Stat.st_size);
+#endif // _HAS_WINDOWS
+}
+
+// FUNCTION file_handle::sync
+_NODISCARD bool file_handle::sync() const {
+    _FILESYSTEM_VERIFY(is_open(), "file is not open", error_type::runtime_error);
+#if _HAS_WINDOWS
+    _FILESYSTEM_VERIFY(FlushFileBuffers(_Myhandle), "failed to synchronize file", error_type::runtime_error);
+#else // ^^^ _HAS_WINDOWS ^^^ / vvv !_HAS_WINDOWS vvv
+    _FILESYSTEM_VERIFY(::fsync(_Myhandle) == 0, "failed to synchronize file", error_type::runtime_error);
+#endif // _HAS_WINDOWS
+    return true;
+}
+
+// FUNCTION file_handle::times
+_NODISCARD file_times file_handle::times() const {
+    const file_info _Info{info()};
+    return {_Info.creation_time, _Info.last_access_time, _Info.last_write_time, _Info.has_creation_time};
+}
+
+// FUNCTION file_handle::write_at
+_NODISCARD size_t file_handle::write_at(const uintmax_t _Offset, const span<const char> _Buffer) const {
+    _FILESYSTEM_VERIFY(is_open(), "file is not open", error_type::runtime_error);
+    size_t _Total{0};
+    while (_Total < _Buffer.size()) { // the system may write less than requested, repeat until everything is written
+#if _HAS_WINDOWS
+        OVERLAPPED _Position{_Overlapped_at(_Offset + _Total)};
+        const unsigned long _Size{static_cast<unsigned long>((_STD min)(_Buffer.size() - _Total, _Max_transfer))};
+        unsigned long _Written{0};
+        _FILESYSTEM_VERIFY(WriteFile(_Myhandle, _Buffer.data() + _Total, _Size, &_Written, &_Position),
+            "failed to write file", error_type::runtime_error);
+#else // ^^^ _HAS_WINDOWS ^^^ / vvv !_HAS_WINDOWS vvv
+        const ssize_t _Written{::pwrite(_Myhandle, _Buffer.data() + _Total, _Buffer.size() - _Total,
+            static_cast<off_t>(_Offset + _Total))};
+        if (_Written < 0) {
+            _FILESYSTEM_VERIFY(errno == EINTR, "failed to write file", error_type::runtime_error);
+            continue;
+        }
+#endif // _HAS_WINDOWS
+        _Total += static_cast<size_t>(_Written);
+    }
+
+    return _Total;
+}
+_FILESYSTEM_END
\ No newline at end of file
@@ -17,24 +17,55 @@
 #define _HAS_WINDOWS 0
 #endif // _WIN32
 
+#if !_HAS_WINDOWS && !defined(__linux__)
+#error The contents of <filesystem.hpp> are available only with Windows 10 and Linux.
+#endif // !_HAS_WINDOWS && !defined(__linux__)
+
 // Filesystem Api
 #ifndef _FILESYSTEM_API
+#if _HAS_WINDOWS
 #ifdef FILESYSTEM_EXPORTS
 #define _FILESYSTEM_API __declspec(dllexport)
 #else // ^^^ FILESYSTEM_EXPORTS ^^^ / vvv !FILESYSTEM_EXPORTS vvv
 #define _FILESYSTEM_API __declspec(dllimport)
 #endif // FILESYSTEM_EXPORTS
+#else // ^^^ _HAS_WINDOWS ^^^ / vvv !_HAS_WINDOWS vvv
+#define _FILESYSTEM_API // shared object exports everything with default visibility
+#endif // _HAS_WINDOWS
 #endif // _FILESYSTEM_API
 
+#if _HAS_WINDOWS
 // Some macros may be defined in <yvals_core.h> and <yvals.h>.
 #include <yvals_core.h>
 #include <yvals.h>
+#else // ^^^ _HAS_WINDOWS ^^^ / vvv !_HAS_WINDOWS vvv
+// Macros from <yvals_core.h> and <yvals.h> that are used by filesystem.
+#ifndef _STD
+#define _STD ::std::
+#endif // _STD
+
+#ifndef _CSTD
+#define _CSTD ::
+#endif // _CSTD
+
+#ifndef _HAS_CXX20
+#define _HAS_CXX20 (__cplusplus >= 202002L)
+#endif // _HAS_CXX20
+
+#ifndef _RERAISE
+#define _RERAISE throw
+#endif // _RERAISE
+#endif // _HAS_WINDOWS
 
 // Attributes
 #ifndef _NODISCARD
 #define _NODISCARD [[nodiscard]]
 #endif // _NODISCARD
 
+#ifndef _NORETURN
+#define _NORETURN [[noreturn]]
+#endif // _NORETURN
+
 // Exceptions
 #ifndef _THROW
 #define _THROW(_Errm) throw _Errm
@@ -100,9 +131,7 @@ constexpr _Bitmask& operator^=(_Bitmask& _Left, const _Bitmask _Right) noexcept
 }
 #endif // _BITOPS
 
-#if !_HAS_WINDOWS
-#pragma message("The contents of <filesystem.hpp> are available only with Windows 10.")
-#else // ^^^ !_HAS_WINDOWS ^^^ / vvv _HAS_WINDOWS vvv
+#if _HAS_WINDOWS
 #pragma warning(push)
 #pragma warning(disable : 4996) // C4996: using deprecated content
 #pragma warning(disable : 4251) // C4251: some STL classes requires dll library
@@ -110,39 +139,27 @@ constexpr _Bitmask& operator^=(_Bitmask& _Left, const _Bitmask _Right) noexcept
 // These libraries contains each function/macro/type that filesystem.dll uses.
 // <Windows.h> must be included before C-libraries.
 #include <Windows.h>
-#include <array>
-#include <codecvt>
 #include <combaseapi.h>
 #include <coml2api.h>
 #include <CommCtrl.h>
 #include <corecrt_wstring.h>
 #include <errhandlingapi.h>
 #include <fileapi.h>
-#include <fstream>
 #include <handleapi.h>
 #include <ioapiset.h>
-#include <iosfwd>
-#include <iostream>
-#include <istream>
 #include <libloaderapi.h>
-#include <limits.h>
-#include <locale>
 #include <minwinbase.h>
 #include <objbase.h>
 #include <objidl.h>
-#include <ostream>
 #include <processenv.h>
 #include <ShlGuid.h>
 #include <shellapi.h>
 #include <ShObjIdl.h>
 #include <ShObjIdl_core.h>
-#include <stdexcept>
-#include <string>
 #include <stringapiset.h>
 #include <timezoneapi.h>
 #include <vcruntime.h>
 #include <vcruntime_string.h>
-#include <vector>
 #include <WinBase.h>
 #include <winerror.h>
 #include <winioctl.h>
@@ -152,6 +169,31 @@ constexpr _Bitmask& operator^=(_Bitmask& _Left, const _Bitmask _Right) noexcept
 #include <xlocbuf>
 #include <xutility>
 #include <xtr1common>
+#endif // _HAS_WINDOWS
+
+// These libraries are used on every platform.
+#include <array>
+#include <bit>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iosfwd>
+#include <iostream>
+#include <istream>
+#include <iterator>
+#include <limits.h>
+#include <locale>
+#include <memory>
+#include <ostream>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
 
 // STD allocators
 using _STD allocator;
@@ -161,11 +203,6 @@ using _STD vector;
 // STD characters
 using _STD char_traits;
 
-// STD conversion
-using _STD codecvt_utf8;
-using _STD codecvt_utf8_utf16;
-using _STD wstring_convert;
-
 // STD exceptions
 using _STD exception;
 using _STD invalid_argument;
@@ -178,6 +215,10 @@ using _STD fstream;
 using _STD ifstream;
 using _STD ofstream;
 
+// STD iterators
+using _STD bidirectional_iterator_tag;
+using _STD input_iterator_tag;
+
 // STD streams
 using _STD basic_istream;
 using _STD basic_ostream;
@@ -187,6 +228,9 @@ using _STD ostream;
 using _STD wistream;
 using _STD wostream;
 
+// STD spans
+using _STD span;
+
 // STD strings
 using _STD basic_string;
 using _STD string;
@@ -204,13 +248,34 @@ using _STD u32string_view;
 using _STD wstring_view;
 
 _FILESYSTEM_BEGIN
+#if _HAS_WINDOWS
 // expected slash on Windows 10
 inline constexpr char _Expected_slash   = '\\';
 inline constexpr char _Unexpected_slash = '/'; // default on Linux
+#else // ^^^ _HAS_WINDOWS ^^^ / vvv !_HAS_WINDOWS vvv
+// expected slash on Linux
+inline constexpr char _Expected_slash   = '/';
+inline constexpr char _Unexpected_slash = '\\'; // default on Windows 10
+#endif // _HAS_WINDOWS
+
+// expected slash as null-terminated string (for concatenation)
+inline constexpr char _Expected_slash_string[] = {_Expected_slash, '\0'};
+
+// CONSTANT _Has_unexpected_slash
+inline constexpr bool _Has_unexpected_slash = _HAS_WINDOWS != 0; // on Linux '\\' is a legal character of names
+
+// FUNCTION _Is_slash
+_NODISCARD constexpr bool _Is_slash(const char _Ch) noexcept {
+    return _Ch == _Expected_slash || (_Has_unexpected_slash && _Ch == _Unexpected_slash);
+}
+
+// CONSTANT _Is_any_of_v
+template <class _Ty, class... _Types>
+inline constexpr bool _Is_any_of_v = (_STD is_same_v<_Ty, _Types> || ...);
 
 // CONSTANT _Is_char_t
 template <class _Ty>
-inline constexpr bool _Is_char_t = _STD _Is_any_of_v<_Ty, char, char8_t, char16_t, char32_t, wchar_t>;
+inline constexpr bool _Is_char_t = _Is_any_of_v<_Ty, char, char8_t, char16_t, char32_t, wchar_t>;
 
 // CONSTANT _Is_narrow_char_t
 template <class _Ty>
@@ -218,15 +283,20 @@ inline constexpr bool _Is_narrow_char_t = _STD is_same_v<_Ty, char>;
 
 // CONSTANT _Is_src_t
 template <class _Ty>
-inline constexpr bool _Is_src_t = _STD _Is_any_of_v<_Ty, string, u8string, u16string, u32string, wstring,
+inline constexpr bool _Is_src_t = _Is_any_of_v<_Ty, string, u8string, u16string, u32string, wstring,
     string_view, u8string_view, u16string_view, u32string_view, wstring_view>;
 
 // CONSTANT _Is_narrow_src_t
 template <class _Ty>
-inline constexpr bool _Is_narrow_src_t = _STD _Is_any_of_v<_Ty, string, string_view>;
+inline constexpr bool _Is_narrow_src_t = _Is_any_of_v<_Ty, string, string_view>;
 
 // CONSTANT _Max_path
-inline constexpr size_t _Max_path = 260;
+#ifdef _FILESYSTEM_MAX_PATH
+// Must be the same for the library and every program that uses it, because it changes the size of path.
+inline constexpr size_t _Max_path = _FILESYSTEM_MAX_PATH;
+#else // ^^^ _FILESYSTEM_MAX_PATH ^^^ / vvv !_FILESYSTEM_MAX_PATH vvv
+inline constexpr size_t _Max_path = 260; // MAX_PATH
+#endif // _FILESYSTEM_MAX_PATH
 
 // ENUM CLASS error_type
 enum class _FILESYSTEM_API error_type : unsigned int { // error type for _Throw_system_error
@@ -242,69 +312,275 @@ enum class _FILESYSTEM_API code_page {
 };
 
 // FUNCTION _Throw_system_error
-_FILESYSTEM_API __declspec(noreturn) void _Throw_system_error(const char* const _Src, const char* const _Msg, const error_type _Code);
+_FILESYSTEM_API _NORETURN void _Throw_system_error(const char* const _Src, const char* const _Msg, const error_type _Code);
 
 // FUNCTION _Convert_narrow_to_wide
 _FILESYSTEM_API _NODISCARD wstring _Convert_narrow_to_wide(const code_page _Cp, const string_view _Input);
 
+// converts into _Output without allocating, returns the number of written characters
+_FILESYSTEM_API _NODISCARD size_t _Convert_narrow_to_wide(
+    const code_page _Cp, const string_view _Input, const span<wchar_t> _Output);
+
 // FUNCTION _Convert_wide_to_narrow
 _FILESYSTEM_API _NODISCARD string _Convert_wide_to_narrow(const code_page _Cp, const wstring_view _Input);
 
+// converts into _Output without allocating, returns the number of written characters
+_FILESYSTEM_API _NODISCARD size_t _Convert_wide_to_narrow(
+    const code_page _Cp, const wstring_view _Input, const span<char> _Output);
+
 // FUNCTION TEMPLATE _Convert_utf_to_wide
 template <class _Elem, class _Traits = char_traits<_Elem>>
-_FILESYSTEM_API _NODISCARD constexpr string _Convert_utf_to_narrow(const basic_string_view<_Elem, _Traits> _Input) noexcept(_Is_narrow_char_t<_Elem>);
+_FILESYSTEM_API _NODISCARD string _Convert_utf_to_narrow(const basic_string_view<_Elem, _Traits> _Input) noexcept(_Is_narrow_char_t<_Elem>);
 
 // FUNCTION TEMPLATE _Convert_narrow_to_utf
 template <class _Elem, class _Traits = char_traits<_Elem>, class _Alloc = allocator<_Elem>>
-_FILESYSTEM_API _NODISCARD constexpr basic_string<_Elem, _Traits, _Alloc> _Convert_narrow_to_utf(
+_FILESYSTEM_API _NODISCARD basic_string<_Elem, _Traits, _Alloc> _Convert_narrow_to_utf(
     const string_view _Input) noexcept(_Is_narrow_char_t<_Elem>);
 
 // FUNCTION TEMPLATE _Convert_to_narrow
 template <class _Elem, class _Traits = char_traits<_Elem>>
-_FILESYSTEM_API _NODISCARD constexpr string _Convert_to_narrow(const basic_string_view<_Elem, _Traits> _Input) noexcept(_Is_narrow_char_t<_Elem>);
+_FILESYSTEM_API _NODISCARD string _Convert_to_narrow(const basic_string_view<_Elem, _Traits> _Input) noexcept(_Is_narrow_char_t<_Elem>);
+
+// FUNCTION is_valid_utf8
+// checks if _Input is well-formed UTF-8 (no overlong forms, surrogates or code points above U+10FFFF)
+_FILESYSTEM_API _NODISCARD bool is_valid_utf8(const string_view _Input) noexcept;
+
+// FUNCTION utf8_length_of
+// returns the number of bytes needed to store _Input as UTF-8
+_FILESYSTEM_API _NODISCARD size_t utf8_length_of(const u16string_view _Input) noexcept;
+_FILESYSTEM_API _NODISCARD size_t utf8_length_of(const u32string_view _Input) noexcept;
+_FILESYSTEM_API _NODISCARD size_t utf8_length_of(const wstring_view _Input) noexcept;
+
+// FUNCTION utf16_length_of
+// returns the number of UTF-16 code units needed to store the UTF-8 _Input
+_FILESYSTEM_API _NODISCARD size_t utf16_length_of(const string_view _Input) noexcept;
+
+// FUNCTION utf32_length_of
+// returns the number of UTF-32 code units needed to store the UTF-8 _Input
+_FILESYSTEM_API _NODISCARD size_t utf32_length_of(const string_view _Input) noexcept;
 
 // PREDEFINED CLASS path
 class path;
 
+// PREDEFINED CLASS path_view
+class path_view;
+
+// PREDEFINED CLASS path_builder
+class path_builder;
+
 // FUNCTION TEMPLATE operator>>
 template <class _Elem, class _Traits = char_traits<_Elem>>
-_FILESYSTEM_API _NODISCARD constexpr basic_istream<_Elem, _Traits>& operator>>(basic_istream<_Elem, _Traits>& _Istr, path& _Path);
+_FILESYSTEM_API _NODISCARD basic_istream<_Elem, _Traits>& operator>>(basic_istream<_Elem, _Traits>& _Istr, path& _Path);
 
 // FUNCTION TEMPLATE operator<<
 template <class _Elem, class _Traits = char_traits<_Elem>>
-_FILESYSTEM_API _NODISCARD constexpr basic_ostream<_Elem, _Traits>& operator<<(basic_ostream<_Elem, _Traits>& _Ostr, const path& _Path);
+_FILESYSTEM_API _NODISCARD basic_ostream<_Elem, _Traits>& operator<<(basic_ostream<_Elem, _Traits>& _Ostr, const path& _Path);
 
 // FUNCTION TEMPLATE operator+
 _FILESYSTEM_API _NODISCARD path operator+(const path& _Left, const path& _Right);
 template <class _CharTy>
-_FILESYSTEM_API _NODISCARD constexpr path operator+(const path& _Left, const _CharTy* const _Right);
+_FILESYSTEM_API _NODISCARD path operator+(const path& _Left, const _CharTy* const _Right);
 template <class _CharTy>
-_FILESYSTEM_API _NODISCARD constexpr path operator+(const _CharTy* const _Left, const path& _Right);
+_FILESYSTEM_API _NODISCARD path operator+(const _CharTy* const _Left, const path& _Right);
 template <class _Elem, class _Traits = char_traits<_Elem>, class _Alloc = allocator<_Elem>>
-_FILESYSTEM_API _NODISCARD constexpr path operator+(const path& _Left, const basic_string<_Elem, _Traits, _Alloc>& _Right);
+_FILESYSTEM_API _NODISCARD path operator+(const path& _Left, const basic_string<_Elem, _Traits, _Alloc>& _Right);
 template <class _Elem, class _Traits = char_traits<_Elem>, class _Alloc = allocator<_Elem>>
-_FILESYSTEM_API _NODISCARD constexpr path operator+(const basic_string<_Elem, _Traits, _Alloc>& _Left, const path& _Right);
+_FILESYSTEM_API _NODISCARD path operator+(const basic_string<_Elem, _Traits, _Alloc>& _Left, const path& _Right);
+
+// STRUCT _Path_index
+struct _Path_index { // positions of the path components, refreshed whenever the path changes
+    static constexpr auto npos{static_cast<size_t>(-1)};
+
+    size_t _Root_size   = 0; // 3 if has drive ("D:\"), 1 if starts with slash, otherwise 0
+    size_t _First_slash = npos; // first expected slash
+    size_t _Last_slash  = npos; // last expected slash
+    size_t _First_dot   = npos;
+    size_t _Last_dot    = npos;
+    size_t _Count       = 0; // number of components (drive included)
+    bool _Unexpected    = false; // true if contains any unexpected slash
+};
+
+// FUNCTION _Root_size
+_NODISCARD constexpr size_t _Root_size(const string_view _Text) noexcept {
+    if (_Text.size() >= 3 && _Text[1] == ':' && _Is_slash(_Text[2])
+        && ((_Text[0] >= 'A' && _Text[0] <= 'Z') || (_Text[0] >= 'a' && _Text[0] <= 'z'))) { // for example: "D:\"
+        return 3;
+    } else if (!_Text.empty() && _Is_slash(_Text[0])) {
+        return 1;
+    } else {
+        return 0;
+    }
+}
+
+// FUNCTION _Finish_path_index
+constexpr void _Finish_path_index(
+    _Path_index& _Index, const string_view _Text, size_t _Idx, bool _In_component) noexcept {
+    // indexes characters from _Idx (the SIMD part is done by the library, compile-time literals start from 0)
+    for (; _Idx < _Text.size(); ++_Idx) {
+        switch (_Text[_Idx]) {
+        case _Expected_slash:
+            if (_Index._First_slash == _Path_index::npos) {
+                _Index._First_slash = _Idx;
+            }
+
+            _Index._Last_slash = _Idx;
+            _In_component      = false;
+            break;
+        case _Unexpected_slash:
+            if (_Has_unexpected_slash) {
+                _Index._Unexpected = true;
+                _In_component      = false;
+            } else if (!_In_component) { // an ordinary character on Linux, starts the next component
+                ++_Index._Count;
+                _In_component = true;
+            }
+
+            break;
+        case '.':
+            if (_Index._First_dot == _Path_index::npos) {
+                _Index._First_dot = _Idx;
+            }
+
+            _Index._Last_dot = _Idx;
+            [[fallthrough]];
+        default:
+            if (!_In_component) { // first character of the next component
+                ++_Index._Count;
+                _In_component = true;
+            }
+
+            break;
+        }
+    }
+
+    _Index._Root_size = _Root_size(_Text);
+}
+
+// FUNCTION _Hash_path
+_NODISCARD constexpr size_t _Hash_path(const string_view _Text) noexcept {
+    // mixes 8 bytes at a time (xxHash64 round and avalanche), usable in constant expressions
+    constexpr uint64_t _Prime1{0x9E3779B185EBCA87ULL};
+    constexpr uint64_t _Prime2{0xC2B2AE3D27D4EB4FULL};
+    constexpr uint64_t _Prime3{0x165667B19E3779F9ULL};
+    const char* _First{_Text.data()};
+    size_t _Count{_Text.size()};
+    uint64_t _Hash{_Prime3 ^ (static_cast<uint64_t>(_Count) * _Prime1)};
+    const auto _Load = [](const char* const _Ptr, const size_t _Bytes) noexcept { // unaligned, native byte order
+        if (_STD is_constant_evaluated()) {
+            array<char, sizeof(uint64_t)> _Buff{};
+            for (size_t _Idx = 0; _Idx < _Bytes; ++_Idx) {
+                _Buff[_Idx] = _Ptr[_Idx];
+            }
+
+            return _STD bit_cast<uint64_t>(_Buff);
+        } else {
+            uint64_t _Word{0};
+            _CSTD memcpy(&_Word, _Ptr, _Bytes);
+            return _Word;
+        }
+    };
+
+    for (; _Count >= sizeof(uint64_t); _First += sizeof(uint64_t), _Count -= sizeof(uint64_t)) {
+        _Hash ^= _STD rotl(_Load(_First, sizeof(uint64_t)) * _Prime2, 31) * _Prime1;
+        _Hash  = _STD rotl(_Hash, 27) * _Prime1 + _Prime3;
+    }
+
+    if (_Count > 0) { // last 1-7 bytes
+        _Hash ^= _STD rotl(_Load(_First, _Count) * _Prime2, 31) * _Prime1;
+        _Hash  = _STD rotl(_Hash, 27) * _Prime1 + _Prime3;
+    }
+
+    _Hash ^= _Hash >> 33;
+    _Hash *= _Prime2;
+    _Hash ^= _Hash >> 29;
+    _Hash *= _Prime3;
+    _Hash ^= _Hash >> 32;
+    return static_cast<size_t>(_Hash);
+}
+
+// CLASS path_component_iterator
+class _FILESYSTEM_API path_component_iterator { // walks the components (text between slashes) of the path
+public:
+    using iterator_concept  = bidirectional_iterator_tag;
+    using iterator_category = input_iterator_tag; // returns components by value
+    using value_type        = path_view;
+    using difference_type   = ptrdiff_t;
+    using pointer           = void;
+    using reference         = path_view;
+
+    path_component_iterator() noexcept;
+    ~path_component_iterator() noexcept = default;
+
+    // iterator at the first component (_Pos == _First) or the end (_Pos == _Last) of [_First, _Last)
+    path_component_iterator(const char* const _First, const char* const _Last, const char* const _Pos) noexcept;
+
+    _NODISCARD path_view operator*() const noexcept;
+
+    path_component_iterator& operator++() noexcept;
+    path_component_iterator operator++(int) noexcept;
+
+    path_component_iterator& operator--() noexcept;
+    path_component_iterator operator--(int) noexcept;
+
+    _NODISCARD bool operator==(const path_component_iterator& _Other) const noexcept;
+    _NODISCARD bool operator!=(const path_component_iterator& _Other) const noexcept;
+
+    // returns the current component as string_view
+    _NODISCARD string_view component() const noexcept;
+
+private:
+    const char* _Myfirst; // first character of the path
+    const char* _Mylast; // one past the last character of the path
+    const char* _Mybegin; // first character of the current component
+    const char* _Myend; // one past the last character of the current component
+};
+
+// CLASS path_component_range
+class _FILESYSTEM_API path_component_range { // pair of component iterators, usable in range-based for
+public:
+    path_component_range(const path_component_iterator _First, const path_component_iterator _Last) noexcept;
+    ~path_component_range() noexcept = default;
+
+    _NODISCARD path_component_iterator begin() const noexcept;
+    _NODISCARD path_component_iterator end() const noexcept;
+
+private:
+    path_component_iterator _Myfirst;
+    path_component_iterator _Mylast;
+};
+
+namespace path_literals {
+    // STRUCT _Path_literal_access
+    struct _Path_literal_access;
+} // path_literals
 
 // CLASS path
-class _FILESYSTEM_API path { // takes any string of characters
+class _FILESYSTEM_API path { // takes any string of characters, stores up to _Max_path characters without allocation
 public:
     using value_type      = char;
     using string_type     = string;
-    using size_type       = typename string_type::size_type;
-    using pointer         = typename string_type::pointer;
-    using const_pointer   = typename string_type::const_pointer;
-    using reference       = typename string_type::reference;
-    using const_reference = typename string_type::const_reference;
+    using size_type       = size_t;
+    using pointer         = value_type*;
+    using const_pointer   = const value_type*;
+    using reference       = value_type&;
+    using const_reference = const value_type&;
+
+    using iterator       = pointer;
+    using const_iterator = const_pointer;
 
-    using iterator       = typename string_type::iterator;
-    using const_iterator = typename string_type::const_iterator;
+    using reverse_iterator       = _STD reverse_iterator<iterator>;
+    using const_reverse_iterator = _STD reverse_iterator<const_iterator>;
 
-    using reverse_iterator       = typename string_type::reverse_iterator;
-    using const_reverse_iterator = typename string_type::const_reverse_iterator;
+#if _HAS_WINDOWS
+    using native_value_type = wchar_t; // Win32 API expects UTF-16
+#else // ^^^ _HAS_WINDOWS ^^^ / vvv !_HAS_WINDOWS vvv
+    using native_value_type = char; // Linux API takes the bytes as they are
+#endif // _HAS_WINDOWS
+    using native_string_view = basic_string_view<native_value_type>;
 
     static constexpr auto npos{static_cast<size_type>(-1)};
 
-    path()            = default;
+    path() noexcept;
     path(const path&) = default;
     path(path&&)      = default;
     ~path()           = default;
@@ -315,6 +591,8 @@ public:
     template <class _Src>
     path(const _Src& _Source); // all string types
 
+    path(const path_view _Source);
+
     path& operator=(const path& _Source);
     path& assign(const path& _Source);
 
@@ -346,6 +624,7 @@ public:
     path& append(const _Src& _Added); // all string types
 
     bool operator==(const path& _Compare) const noexcept;
+    bool operator==(const path_view _Compare) const noexcept;
 
     template <class _CharTy>
     bool operator==(const _CharTy* const _Compare) const;
@@ -354,6 +633,7 @@ public:
     bool operator==(const _Src& _Compare) const;
 
     bool operator!=(const path& _Compare) const noexcept;
+    bool operator!=(const path_view _Compare) const noexcept;
 
     template <class _CharTy>
     bool operator!=(const _CharTy* const _Compare) const;
@@ -361,19 +641,26 @@ public:
     template <class _Src>
     bool operator!=(const _Src& _Compare) const;
 
-    _NODISCARD constexpr reference operator[](const size_type _Pos);
-    _NODISCARD constexpr const_reference operator[](const size_type _Pos) const;
+    // characters are read-only, every change goes through a member function that keeps the index up to date
+    _NODISCARD const_reference operator[](const size_type _Pos) const;
 
     // returns element at _Pos position
-    _NODISCARD constexpr reference at(const size_type _Pos);
-    _NODISCARD constexpr const_reference at(const size_type _Pos) const;
+    _NODISCARD const_reference at(const size_type _Pos) const;
 
     // returns iterator with first element
-    _NODISCARD constexpr iterator begin() noexcept;
-    _NODISCARD constexpr const_iterator begin() const noexcept;
+    _NODISCARD const_iterator begin() const noexcept;
+
+    // returns the current working path in the native encoding (always null-terminated)
+    _NODISCARD const native_value_type* c_str() const noexcept;
 
     // clears the current working path
-    constexpr void clear() noexcept;
+    void clear() noexcept;
+
+    // returns the components of the current working path (valid until the path changes)
+    _NODISCARD path_component_range components() const noexcept;
+
+    // returns the number of components in the current working path
+    _NODISCARD size_t components_count() const noexcept;
 
     // returns the directory from the current working path (if has)
     _NODISCARD path directory() const noexcept;
@@ -382,11 +669,10 @@ public:
     _NODISCARD path drive() const noexcept;
 
     // checks if the current working path is empty
-    _NODISCARD constexpr bool empty() const noexcept;
+    _NODISCARD bool empty() const noexcept;
 
     // returns iterator with last element
-    _NODISCARD constexpr iterator end() noexcept;
-    _NODISCARD constexpr const_iterator end() const noexcept;
+    _NODISCARD const_iterator end() const noexcept;
 
     // returns the extension from the current working path (if has)
     _NODISCARD path extension() const noexcept;
@@ -434,6 +720,9 @@ public:
     // checks if the current working path has the stem (filename without extension)
     _NODISCARD bool has_stem() const noexcept;
 
+    // returns the hash of the current working path (computed when the path changes)
+    _NODISCARD size_t hash() const noexcept;
+
     // checks if the current working path is absolute
     _NODISCARD bool is_absolute() const noexcept;
     
@@ -443,6 +732,12 @@ public:
     // converts the current working path to the Windows 10 standard
     _NODISCARD path& make_preferred() noexcept;
 
+    // returns the current working path in the native encoding
+    _NODISCARD native_string_view native() const noexcept;
+
+    // removes "." and ".." components and unnecessary slashes without accessing the disk
+    _NODISCARD path& normalize() noexcept;
+
     // returns the parent directory from the current working path
     _NODISCARD path parent_directory() const noexcept;
 
@@ -450,8 +745,7 @@ public:
     _NODISCARD path parent_path() const noexcept;
 
     // returns reverse iterator with first element
-    _NODISCARD constexpr reverse_iterator rend() noexcept;
-    _NODISCARD constexpr const_reverse_iterator rend() const noexcept;
+    _NODISCARD const_reverse_iterator rend() const noexcept;
 
     // removes the directory from the current working path (if has)
     _NODISCARD path& remove_directory(const bool _With_slash = true) noexcept;
@@ -475,7 +769,7 @@ public:
     _NODISCARD path& replace_stem(const path& _Replacement);
 
     // resizes the path to _Newsize
-    constexpr void resize(const size_type _Newsize, const value_type _Ch = value_type(0));
+    void resize(const size_type _Newsize, const value_type _Ch = value_type(0));
 
     // returns the root directory from the current working path (if has)
     _NODISCARD path root_directory() const noexcept;
@@ -484,16 +778,249 @@ public:
     _NODISCARD path root_path() const noexcept;
 
     // returns the size of the current working path
-    _NODISCARD constexpr size_t size() const noexcept;
+    _NODISCARD size_t size() const noexcept;
 
     // returns the stem (file name without the extension) from the current working path (if has)
     _NODISCARD path stem() const noexcept;
 
 private:
+    friend path_view;
+    friend path_builder;
+    friend path_literals::_Path_literal_access;
+
+    // path with the index and the hash computed in advance, _Text must be valid and short enough (path literals)
+    path(const string_view _Text, const _Path_index& _Index, const size_t _Hash) noexcept;
+
+    // returns the current working path as view
+    _NODISCARD string_view _Text() const noexcept;
+
+    // replaces the current working path with _Newtext
+    void _Assign(const string_view _Newtext);
+
+    // appends _Added to the current working path
+    void _Append(const string_view _Added);
+
+    // updates the index, the hash and the native text after characters were written from _Old_size,
+    // _Old_size must be 0 or point to a slash or follow one (no component may continue across it)
+    void _Extend(const size_type _Old_size) noexcept;
+
+    // verifies that narrow input can be converted to the native encoding
+    static void _Check_encoding(const string_view _Narrow);
+
     // verifies path size
-    constexpr void _Check_size() const;
-    
-    string_type _Mytext; // current working path
+    static void _Check_size(const size_type _Newsize);
+
+    // returns the index of the current working path
+    _NODISCARD _Path_index _Index() const noexcept;
+
+    // rebuilds the index and the native text after the current working path has been changed
+    void _Reindex() noexcept;
+
+#if _HAS_WINDOWS
+    // converts the current working path to UTF-16
+    void _Refresh_native() noexcept;
+#endif // _HAS_WINDOWS
+
+    value_type _Mytext[_Max_path + 1]; // current working path (always null-terminated)
+    size_type _Mysize; // length of the current working path
+    _Path_index _Myindex; // components of the current working path
+    size_t _Myhash; // hash of the current working path
+#if _HAS_WINDOWS
+    // UTF-16 copy of the current working path, passed directly to the Win32 API
+    native_value_type _Mynative[_Max_path + 1];
+    size_type _Mynative_size;
+#endif // _HAS_WINDOWS
+};
+
+// CLASS path_view
+class _FILESYSTEM_API path_view { // refers to the path or any narrow string, never allocates
+public:
+    using value_type      = char;
+    using size_type       = size_t;
+    using const_pointer   = const value_type*;
+    using const_reference = const value_type&;
+
+    using const_iterator         = const_pointer;
+    using const_reverse_iterator = _STD reverse_iterator<const_iterator>;
+
+    static constexpr auto npos{static_cast<size_type>(-1)};
+
+    path_view() noexcept;
+    path_view(const path_view&) noexcept = default;
+    ~path_view() noexcept                = default;
+
+    path_view(const path& _Source) noexcept;
+    path_view(const char* const _Source) noexcept;
+    path_view(const string& _Source) noexcept;
+    path_view(const string_view _Source) noexcept;
+
+    // view with the index and the hash computed in advance (used by path literals)
+    constexpr path_view(const string_view _Source, const _Path_index& _Index, const size_t _Hash) noexcept
+        : _Mydata(_Source.data()), _Mysize(_Source.size()), _Myindex(_Index), _Myhash(_Hash) {}
+
+    path_view& operator=(const path_view&) noexcept = default;
+
+    bool operator==(const path_view _Compare) const noexcept;
+    bool operator!=(const path_view _Compare) const noexcept;
+
+    _NODISCARD const_reference operator[](const size_type _Pos) const noexcept;
+
+    // returns element at _Pos position
+    _NODISCARD const_reference at(const size_type _Pos) const;
+
+    // returns iterator with first element
+    _NODISCARD const_iterator begin() const noexcept;
+
+    // returns the components of the viewed path
+    _NODISCARD path_component_range components() const noexcept;
+
+    // returns the number of components in the viewed path
+    _NODISCARD size_t components_count() const noexcept;
+
+    // returns pointer to the first element (not necessarily null-terminated)
+    _NODISCARD const_pointer data() const noexcept;
+
+    // returns the directory from the viewed path (if has)
+    _NODISCARD path_view directory() const noexcept;
+
+    // returns the drive from the viewed path (if has)
+    _NODISCARD path_view drive() const noexcept;
+
+    // checks if the viewed path is empty
+    _NODISCARD bool empty() const noexcept;
+
+    // returns iterator with last element
+    _NODISCARD const_iterator end() const noexcept;
+
+    // returns the extension from the viewed path (if has)
+    _NODISCARD path_view extension() const noexcept;
+
+    // returns the filename from the viewed path (if has)
+    _NODISCARD path_view file() const noexcept;
+
+    // returns the viewed path as string
+    _NODISCARD const string generic_string() const;
+
+    // checks if the viewed path has the directory
+    _NODISCARD bool has_directory() const noexcept;
+
+    // checks if the viewed path has the drive
+    _NODISCARD bool has_drive() const noexcept;
+
+    // checks if the viewed path has the extension
+    _NODISCARD bool has_extension() const noexcept;
+
+    // checks if the viewed path has the _Ext extension (without dot)
+    _NODISCARD bool has_extension(const path_view _Ext) const noexcept;
+
+    // checks if the viewed path has the file
+    _NODISCARD bool has_file() const noexcept;
+
+    // checks if the viewed path has the parent directory
+    _NODISCARD bool has_parent_directory() const noexcept;
+
+    // checks if the viewed path has the root directory
+    _NODISCARD bool has_root_directory() const noexcept;
+
+    // checks if the viewed path has the stem (filename without extension)
+    _NODISCARD bool has_stem() const noexcept;
+
+    // returns the hash of the viewed path (same as the hash of equal path)
+    _NODISCARD size_t hash() const noexcept;
+
+    // checks if the viewed path is absolute
+    _NODISCARD bool is_absolute() const noexcept;
+
+    // checks if the viewed path is relative
+    _NODISCARD bool is_relative() const noexcept;
+
+    // returns the parent directory from the viewed path
+    _NODISCARD path_view parent_directory() const noexcept;
+
+    // returns the parent path from the viewed path
+    _NODISCARD path_view parent_path() const noexcept;
+
+    // returns reverse iterator with first element
+    _NODISCARD const_reverse_iterator rend() const noexcept;
+
+    // returns the root directory from the viewed path (if has)
+    _NODISCARD path_view root_directory() const noexcept;
+
+    // returns the root path from the viewed path (if has)
+    _NODISCARD path_view root_path() const noexcept;
+
+    // returns the size of the viewed path
+    _NODISCARD size_t size() const noexcept;
+
+    // returns the stem (file name without the extension) from the viewed path (if has)
+    _NODISCARD path_view stem() const noexcept;
+
+    // returns the viewed path as string_view
+    _NODISCARD string_view view() const noexcept;
+
+private:
+    const value_type* _Mydata; // first character of the viewed path
+    size_type _Mysize; // length of the viewed path
+    _Path_index _Myindex; // components of the viewed path
+    size_t _Myhash; // hash taken from the viewed path, 0 if must be computed
+};
+
+// STRUCT path_hash
+struct _FILESYSTEM_API path_hash { // transparent hash for path, path_view and strings
+    using is_transparent = void;
+
+    _NODISCARD size_t operator()(const path_view _Path) const noexcept;
+};
+
+// STRUCT path_equal
+struct _FILESYSTEM_API path_equal { // transparent equality for path, path_view and strings
+    using is_transparent = void;
+
+    _NODISCARD bool operator()(const path_view _Left, const path_view _Right) const noexcept;
+};
+
+// CLASS path_builder
+class _FILESYSTEM_API path_builder { // appends components to one reusable buffer, never allocates
+public:
+    path_builder() noexcept;
+    ~path_builder() noexcept = default;
+
+    explicit path_builder(const path_view _Base);
+
+    path_builder(const path_builder&)            = default;
+    path_builder& operator=(const path_builder&) = default;
+
+    // returns the number of pushed components
+    _NODISCARD size_t depth() const noexcept;
+
+    // returns the built path
+    _NODISCARD const path& get() const noexcept;
+
+    // removes the last pushed component (if has)
+    void pop() noexcept;
+
+    // appends slash and _Component to the built path
+    path_builder& push(const path_view _Component);
+
+    // replaces the built path with _Base and forgets all pushed components
+    void reset(const path_view _Base);
+
+private:
+    static constexpr size_t _Max_depth = _Max_path / 2 + 1; // every component takes at least 2 characters
+
+    // STRUCT _Push_mark
+    struct _Push_mark { // state of the built path before push(), restored by pop() without rescanning
+        size_t _Size;
+        _Path_index _Index;
+        size_t _Hash;
+#if _HAS_WINDOWS
+        size_t _Native_size;
+#endif // _HAS_WINDOWS
+    };
+
+    path _Mypath; // built path
+    _Push_mark _Mymarks[_Max_depth]; // states of the built path before each push()
+    size_t _Mydepth; // number of pushed components
 };
 
 // CLASS filesystem_error
@@ -526,22 +1053,160 @@ private:
     string _Mywhat; // error message
 };
 
+#if _HAS_WINDOWS
 #pragma warning(push)
 #pragma warning(disable : 4455) // C4455: reserved name
+#else // ^^^ _HAS_WINDOWS ^^^ / vvv !_HAS_WINDOWS vvv
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wliteral-suffix" // reserved name
+#endif // _HAS_WINDOWS
 namespace path_literals {
-    // FUNCTION operator""p
-    _FILESYSTEM_API _NODISCARD path operator""p(const char* const _Str, const size_t _Size) noexcept;
-    _FILESYSTEM_API _NODISCARD path operator""p(const char8_t* const _Str, const size_t _Size) noexcept;
-    _FILESYSTEM_API _NODISCARD path operator""p(const char16_t* const _Str, const size_t _Size) noexcept;
-    _FILESYSTEM_API _NODISCARD path operator""p(const char32_t* const _Str, const size_t _Size) noexcept;
-    _FILESYSTEM_API _NODISCARD path operator""p(const wchar_t* const _Str, const size_t _Size) noexcept;
+    // FUNCTION _Path_literal_is_too_long
+    void _Path_literal_is_too_long(); // never defined, calling it in a constant expression fails the compilation
+
+    // FUNCTION _Path_literal_is_not_valid_unicode
+    void _Path_literal_is_not_valid_unicode(); // never defined, as above
+
+    // STRUCT TEMPLATE _Path_literal
+    template <class _Elem, size_t _Size>
+    struct _Path_literal { // literal converted to UTF-8, normalized and validated at compile time
+        // UTF-8 needs up to 3 bytes per UTF-16 code unit and up to 4 bytes per UTF-32 code unit
+        static constexpr size_t _Capacity = _Size * (sizeof(_Elem) == 1 ? 1 : sizeof(_Elem) == 2 ? 3 : 4);
+
+        char _Text[_Capacity]{};
+        size_t _Length{0};
+        _Path_index _Index{};
+        size_t _Hash{0};
+
+        consteval _Path_literal(const _Elem (&_Str)[_Size]) {
+            static_assert(_Is_char_t<_Elem>, "invalid character type");
+            for (size_t _Idx = 0; _Idx < _Size - 1; ++_Idx) { // skip null-terminator
+                char32_t _Code{static_cast<char32_t>(_Str[_Idx])};
+                if constexpr (sizeof(_Elem) == 1) { // UTF-8 (char or char8_t), decoded only to be validated
+                    _Code = static_cast<unsigned char>(_Str[_Idx]);
+                    if (_Code >= 0x80) {
+                        _Code = _Decode_utf8(_Str, _Idx);
+                    }
+                } else if constexpr (sizeof(_Elem) == 2) { // UTF-16 (char16_t or wchar_t on Windows)
+                    if (_Code >= 0xD800 && _Code <= 0xDBFF) { // high surrogate, low surrogate must be next
+                        if (_Idx + 1 >= _Size - 1 || _Str[_Idx + 1] < 0xDC00 || _Str[_Idx + 1] > 0xDFFF) {
+                            _Path_literal_is_not_valid_unicode();
+                        }
+
+                        _Code = 0x10000 + ((_Code - 0xD800) << 10) + (static_cast<char32_t>(_Str[++_Idx]) - 0xDC00);
+                    } else if (_Code >= 0xDC00 && _Code <= 0xDFFF) { // low surrogate without high surrogate
+                        _Path_literal_is_not_valid_unicode();
+                    }
+                } else { // UTF-32 (char32_t or wchar_t on Linux)
+                    if (_Code > 0x10FFFF || (_Code >= 0xD800 && _Code <= 0xDFFF)) {
+                        _Path_literal_is_not_valid_unicode();
+                    }
+                }
+
+                if (_Code < 0x80 && _Is_slash(static_cast<char>(_Code))) {
+                    if (_Length == 0 || _Text[_Length - 1] != _Expected_slash) { // leave only single slashes
+                        _Put(_Expected_slash);
+                    }
+                } else if (_Code < 0x80) {
+                    _Put(static_cast<char>(_Code));
+                } else if (_Code < 0x800) {
+                    _Put(static_cast<char>(0xC0 | (_Code >> 6)));
+                    _Put(static_cast<char>(0x80 | (_Code & 0x3F)));
+                } else if (_Code < 0x10000) {
+                    _Put(static_cast<char>(0xE0 | (_Code >> 12)));
+                    _Put(static_cast<char>(0x80 | ((_Code >> 6) & 0x3F)));
+                    _Put(static_cast<char>(0x80 | (_Code & 0x3F)));
+                } else {
+                    _Put(static_cast<char>(0xF0 | (_Code >> 18)));
+                    _Put(static_cast<char>(0x80 | ((_Code >> 12) & 0x3F)));
+                    _Put(static_cast<char>(0x80 | ((_Code >> 6) & 0x3F)));
+                    _Put(static_cast<char>(0x80 | (_Code & 0x3F)));
+                }
+            }
+
+            if (_Length > _Max_path) { // the same limit as path has
+                _Path_literal_is_too_long();
+            }
+
+            _Finish_path_index(_Index, string_view{_Text, _Length}, 0, false);
+            _Hash = _Hash_path(string_view{_Text, _Length});
+        }
+
+        // decodes the multibyte sequence that starts at _Idx, leaves _Idx at its last byte
+        static consteval char32_t _Decode_utf8(const _Elem (&_Str)[_Size], size_t& _Idx) {
+            // the same rules as is_valid_utf8(), no overlong forms, no surrogates and nothing above U+10FFFF
+            char32_t _Code{static_cast<unsigned char>(_Str[_Idx])};
+            size_t _Trail{0};
+            char32_t _Min{0};
+            if (_Code >= 0xC2 && _Code <= 0xDF) {
+                _Trail = 1;
+                _Min   = 0x80;
+                _Code &= 0x1F;
+            } else if (_Code >= 0xE0 && _Code <= 0xEF) {
+                _Trail = 2;
+                _Min   = 0x800;
+                _Code &= 0x0F;
+            } else if (_Code >= 0xF0 && _Code <= 0xF4) {
+                _Trail = 3;
+                _Min   = 0x10000;
+                _Code &= 0x07;
+            } else { // continuation byte or invalid lead byte
+                _Path_literal_is_not_valid_unicode();
+            }
+
+            for (; _Trail > 0; --_Trail) {
+                if (_Idx + 1 >= _Size - 1 || (static_cast<unsigned char>(_Str[_Idx + 1]) & 0xC0) != 0x80) {
+                    _Path_literal_is_not_valid_unicode();
+                }
+
+                _Code = (_Code << 6) | (static_cast<unsigned char>(_Str[++_Idx]) & 0x3F);
+            }
+
+            if (_Code < _Min || _Code > 0x10FFFF || (_Code >= 0xD800 && _Code <= 0xDFFF)) {
+                _Path_literal_is_not_valid_unicode();
+            }
+
+            return _Code;
+        }
+
+        consteval void _Put(const char _Ch) {
+            _Text[_Length++] = _Ch;
+        }
+    };
+
+    // STRUCT _Path_literal_access
+    struct _Path_literal_access { // builds the path of the literal without validating and indexing it again
+        template <class _Elem, size_t _Size>
+        _NODISCARD static path _Make(const _Path_literal<_Elem, _Size>& _Literal) noexcept {
+            return path{string_view{_Literal._Text, _Literal._Length}, _Literal._Index, _Literal._Hash};
+        }
+    };
+
+    // FUNCTION TEMPLATE operator""p
+    template <_Path_literal _Literal>
+    _NODISCARD const path& operator""p() noexcept {
+        // the text, the index and the hash are ready at compile time, the path is built from them only once
+        static const path _Path{_Path_literal_access::_Make(_Literal)};
+        return _Path;
+    }
+
+    // FUNCTION TEMPLATE operator""pv
+    template <_Path_literal _Literal>
+    _NODISCARD constexpr path_view operator""pv() noexcept {
+        // refers to the template parameter object, which lives as long as the program
+        return path_view{string_view{_Literal._Text, _Literal._Length}, _Literal._Index, _Literal._Hash};
+    }
 } // path_literals
+#if _HAS_WINDOWS
 #pragma warning(pop)
+#else // ^^^ _HAS_WINDOWS ^^^ / vvv !_HAS_WINDOWS vvv
+#pragma GCC diagnostic pop
+#endif // _HAS_WINDOWS
 
 // FUNCTION _Throw_fs_error
-_FILESYSTEM_API __declspec(noreturn) void _Throw_fs_error(const char* const _Msg);
-_FILESYSTEM_API __declspec(noreturn) void _Throw_fs_error(const char* const _Msg, const error_type _Code);
-_FILESYSTEM_API __declspec(noreturn) void _Throw_fs_error(const char* const _Msg, const error_type _Code, const path& _Src);
+_FILESYSTEM_API _NORETURN void _Throw_fs_error(const char* const _Msg);
+_FILESYSTEM_API _NORETURN void _Throw_fs_error(const char* const _Msg, const error_type _Code);
+_FILESYSTEM_API _NORETURN void _Throw_fs_error(const char* const _Msg, const error_type _Code, const path& _Src);
 
 // verification macros
 #ifndef _FILESYSTEM_VERIFY
@@ -587,10 +1252,21 @@ _FILESYSTEM_API __declspec(noreturn) void _Throw_fs_error(const char* const _Msg
     _FILESYSTEM_VERIFY(_Handle != INVALID_HANDLE_VALUE, "failed to get handle", error_type::runtime_error)
 #endif // _FILESYSTEM_VERIFY_HANDLE
 
+#ifndef _FILESYSTEM_VERIFY_DESCRIPTOR
+#define _FILESYSTEM_VERIFY_DESCRIPTOR(_Fd) \
+    _FILESYSTEM_VERIFY(_Fd != -1, "failed to get file descriptor", error_type::runtime_error)
+#endif // _FILESYSTEM_VERIFY_DESCRIPTOR
+
+// FUNCTION common_prefix
+_FILESYSTEM_API _NODISCARD path_view common_prefix(const path_view _Left, const path_view _Right) noexcept;
+
 // FUNCTION current_path
 _FILESYSTEM_API _NODISCARD path current_path() noexcept;
 _FILESYSTEM_API _NODISCARD bool current_path(const path& _Path);
 
+// FUNCTION lexically_relative
+_FILESYSTEM_API _NODISCARD path lexically_relative(const path_view _Path, const path_view _Base);
+
 // FUNCTION make_path
 _FILESYSTEM_API _NODISCARD path make_path(const path& _Path, const bool _Module);
 
@@ -658,12 +1334,15 @@ enum class _FILESYSTEM_API file_type : unsigned int {
     not_found,
     directory,
     regular, 
+    symlink,
+    junction, // Windows 10 only
 
-    // there could be also block, character, fifo and socket,
-    // but there's no reason to implement it,
+    // block, character, fifo and socket are reported only on Linux,
     // because Windows 10 don't supports it
-    symlink,
-    junction
+    block,
+    character,
+    fifo,
+    socket
 };
 
 // ENUM CLASS file_share
@@ -676,8 +1355,20 @@ enum class _FILESYSTEM_API file_share : unsigned int {
 
 _BITOPS(file_share)
 
+// ENUM CLASS _File_status_fields
+enum class _FILESYSTEM_API _File_status_fields : unsigned char { // parts of file_status that are already fetched
+    _None        = 0x0,
+    _Existence   = 0x1,
+    _Attribute   = 0x2,
+    _Permissions = 0x4,
+    _Type        = 0x8,
+    _All         = _Existence | _Attribute | _Permissions | _Type
+};
+
+_BITOPS(_File_status_fields)
+
 // CLASS file_status
-class _FILESYSTEM_API file_status {
+class _FILESYSTEM_API file_status { // fetches each field at the first request, with as few system calls as possible
 public:
     file_status() noexcept;
     file_status(const file_status&) = default;
@@ -701,26 +1392,34 @@ public:
     // returns current working path type
     _NODISCARD const file_type type() const noexcept;
 
+    // checks if current working path exists, used by exists()
+    _NODISCARD bool _Exists() const noexcept;
+
 private:
     // inits all
     void _Init() noexcept;
 
-    // refreshs current working path type
-    void _Refresh() noexcept;
+    // fetches these of _Fields that are not known yet
+    void _Refresh(const _File_status_fields _Fields) const noexcept;
+
+    // marks current working path as not found
+    void _Set_not_found() const noexcept;
 
     // sets new attribute to current working path
-    void _Update_attribute(const file_attributes _Newattrib) noexcept;
+    void _Update_attribute(const file_attributes _Newattrib) const noexcept;
 
     // sets new permissions to current working path
-    void _Update_permissions(const file_permissions _Newperms) noexcept;
+    void _Update_permissions(const file_permissions _Newperms) const noexcept;
 
     // sets new type to current working path
-    void _Update_type(const file_type _Newtype) noexcept;
+    void _Update_type(const file_type _Newtype) const noexcept;
 
+    // Fields are filled by the const getters, so an object shared between threads must be synchronized.
     path _Mypath; // current working path
-    file_attributes _Myattr; // current working path attribute
-    file_permissions _Myperms; // current working path right access
-    file_type _Mytype; // current working path type
+    mutable file_attributes _Myattr; // current working path attribute
+    mutable file_permissions _Myperms; // current working path right access
+    mutable file_type _Mytype; // current working path type
+    mutable _File_status_fields _Myknown; // fields that are already fetched
 };
 
 // ENUM CLASS rename_options
@@ -791,6 +1490,9 @@ public:
     _NODISCARD const uintmax_t total_count() const noexcept;
 
 private:
+    // adds _Name to the total and to the list of _Type
+    void _Add(const path& _Name, const file_type _Type);
+
     // inits all
     void _Init() noexcept;
 
@@ -891,7 +1593,7 @@ _FILESYSTEM_API _NODISCARD bool copy_junction(const path& _Junction, const path&
 _FILESYSTEM_API _NODISCARD bool copy_symlink(const path& _Symlink, const path& _Newsymlink);
 
 // STRUCT file_time
-struct _FILESYSTEM_API file_time final {
+struct _FILESYSTEM_API file_time final { // calendar time in the user time zone, see to_local_time()
     // calendar
     uint16_t year;
     uint16_t month;
@@ -903,8 +1605,24 @@ struct _FILESYSTEM_API file_time final {
     uint16_t second;
 };
 
+// STRUCT file_clock
+struct _FILESYSTEM_API file_clock final { // nanoseconds since 1970-01-01 00:00:00 UTC on every system
+    using rep        = int64_t;
+    using period     = _STD nano;
+    using duration   = _STD chrono::duration<rep, period>;
+    using time_point = _STD chrono::time_point<file_clock>;
+
+    static constexpr bool is_steady = false;
+
+    _NODISCARD static time_point now() noexcept;
+
+    // conversions from/to the system clock, both have the same epoch
+    _NODISCARD static time_point from_sys(const _STD chrono::system_clock::time_point _Time) noexcept;
+    _NODISCARD static _STD chrono::system_clock::time_point to_sys(const time_point _Time) noexcept;
+};
+
 // FUNCTION creation_data
-_FILESYSTEM_API _NODISCARD file_time creation_time(const path& _Target);
+_FILESYSTEM_API _NODISCARD file_clock::time_point creation_time(const path& _Target);
 
 // FUNCTION create_directory
 _FILESYSTEM_API _NODISCARD bool create_directory(const path& _Path);
@@ -919,6 +1637,7 @@ _FILESYSTEM_API _NODISCARD bool create_hard_link(const path& _To, const path& _H
 // FUNCTION create_junction
 _FILESYSTEM_API _NODISCARD bool create_junction(const path& _To, const path& _Junction);
 
+#if _HAS_WINDOWS
 namespace experimental {
     // FUNCTION TEMPLATE create_shortcut
 #ifdef _FILESYSTEM_DEPRECATED_SHORTCUT_PARAMETERS
@@ -928,6 +1647,7 @@ namespace experimental {
     _FILESYSTEM_API _NODISCARD bool create_shortcut(const path& _To, const path& _Shortcut, const _CharTy* const _Description = nullptr);
 #endif // _FILESYSTEM_DEPRECATED_SHORTCUT_PARAMETERS
 } // experimental
+#endif // _HAS_WINDOWS
 
 // FUNCTION create_symlink
 _FILESYSTEM_API _NODISCARD bool create_symlink(const path& _To, const path& _Symlink, const symlink_flags _Flags);
@@ -943,52 +1663,266 @@ struct _FILESYSTEM_API file_id final { // copy of _FILE_ID_INFO
 _FILESYSTEM_API _NODISCARD bool equivalent(const path& _Left, const path& _Right);
 
 // FUNCTION exists
-_FILESYSTEM_API _NODISCARD bool exists(const file_status _Status) noexcept;
+_FILESYSTEM_API _NODISCARD bool exists(const file_status& _Status) noexcept;
 _FILESYSTEM_API _NODISCARD bool exists(const path& _Target) noexcept;
 
 // FUNCTION file_size
-_FILESYSTEM_API _NODISCARD size_t file_size(const path& _Target);
+_FILESYSTEM_API _NODISCARD uintmax_t file_size(const path& _Target);
 
 // FUNCTION hard_link_count
 _FILESYSTEM_API _NODISCARD uintmax_t hard_link_count(const path& _Target, const file_flags _Flags);
 _FILESYSTEM_API _NODISCARD uintmax_t hard_link_count(const path& _Target);
 
+// STRUCT file_info
+struct _FILESYSTEM_API file_info final { // everything that info() gets with one query
+    file_type type;
+    uintmax_t size; // 0 for directories on Windows
+    uintmax_t allocation_size; // bytes taken on the disk, may differ from size (sparse and compressed files)
+    uintmax_t hard_link_count;
+    file_clock::time_point creation_time; // valid only if has_creation_time is true
+    file_clock::time_point last_access_time;
+    file_clock::time_point last_write_time;
+    file_id id; // the same for all hard links and for the link and its target if links are followed
+    bool has_creation_time; // false if the file system doesn't store the creation time (Linux only)
+};
+
+// FUNCTION info
+// gets type, size, times, links count and id with one system query, follows links only if _Follow_links is true
+_FILESYSTEM_API _NODISCARD file_info info(const path& _Target, const bool _Follow_links);
+_FILESYSTEM_API _NODISCARD file_info info(const path& _Target);
+
+// STRUCT file_times
+struct _FILESYSTEM_API file_times final { // all times of the file, as stored by the file system
+    file_clock::time_point creation_time; // valid only if has_creation_time is true
+    file_clock::time_point last_access_time;
+    file_clock::time_point last_write_time;
+    bool has_creation_time; // false if the file system doesn't store the creation time (Linux only)
+};
+
+// CLASS file_handle
+class _FILESYSTEM_API file_handle { // owns an open file, the path is resolved only once for all operations
+public:
+#if _HAS_WINDOWS
+    using native_handle_type = HANDLE;
+#else // ^^^ _HAS_WINDOWS ^^^ / vvv !_HAS_WINDOWS vvv
+    using native_handle_type = int;
+#endif // _HAS_WINDOWS
+
+    file_handle() noexcept;
+    explicit file_handle(const path& _Target, const file_access _Access = file_access::readonly,
+        const file_disposition _Disposition = file_disposition::only_if_exists);
+    file_handle(file_handle&& _Other) noexcept;
+    ~file_handle() noexcept;
+
+    file_handle& operator=(file_handle&& _Other) noexcept;
+
+    file_handle(const file_handle&)            = delete;
+    file_handle& operator=(const file_handle&) = delete;
+
+    // closes the file (if is open)
+    void close() noexcept;
+
+    // returns the same as info() would return for the file, links are followed
+    _NODISCARD file_info info() const;
+
+    // returns the id of the file
+    _NODISCARD file_id id() const;
+
+    // checks if the file is open
+    _NODISCARD bool is_open() const noexcept;
+
+    // returns the number of hard links to the file
+    _NODISCARD uintmax_t link_count() const;
+
+    // returns the system handle (Windows) or file descriptor (Linux)
+    _NODISCARD native_handle_type native_handle() const noexcept;
+
+    // reads up to _Buffer.size() bytes from _Offset, returns the number of read bytes (less only at the end)
+    _NODISCARD size_t read_at(const uintmax_t _Offset, const span<char> _Buffer) const;
+
+    // truncates or extends the file to _Newsize bytes
+    _NODISCARD bool resize(const uintmax_t _Newsize) const;
+
+    // returns the size of the file
+    _NODISCARD uintmax_t size() const;
+
+    // writes all buffered data of the file to the disk
+    _NODISCARD bool sync() const;
+
+    // returns all times of the file
+    _NODISCARD file_times times() const;
+
+    // writes all of _Buffer at _Offset, returns the number of written bytes
+    _NODISCARD size_t write_at(const uintmax_t _Offset, const span<const char> _Buffer) const;
+
+private:
+    native_handle_type _Myhandle; // INVALID_HANDLE_VALUE or -1 if not open
+};
+
+// STRUCT _Status_cache_state
+struct _Status_cache_state;
+
+// CLASS status_cache
+class _FILESYSTEM_API status_cache { // remembers info() of paths, meant to be shared by the whole process
+public:
+    // Entries expire after _Ttl. On Linux they are also dropped as soon as inotify reports a change
+    // in the parent directory, _Ttl only covers changes that inotify doesn't see (e.g. network file systems).
+    // Expired entries, and watches of directories without cached children, are removed as the cache grows.
+    explicit status_cache(const _STD chrono::milliseconds _Ttl = _STD chrono::milliseconds{1000});
+    ~status_cache() noexcept;
+
+    status_cache(const status_cache&)            = delete;
+    status_cache& operator=(const status_cache&) = delete;
+
+    // removes all entries
+    void clear() noexcept;
+
+    // the same as exists(), but cached
+    _NODISCARD bool exists(const path& _Target);
+
+    // the same as file_size(), but cached
+    _NODISCARD uintmax_t file_size(const path& _Target);
+
+    // returns the number of lookups answered from the cache
+    _NODISCARD uintmax_t hits() const noexcept;
+
+    // the same as info(), but cached (links aren't followed)
+    _NODISCARD file_info info(const path& _Target);
+
+    // removes the entry of _Target (if has)
+    void invalidate(const path& _Target) noexcept;
+
+    // the same as is_directory(), but cached
+    _NODISCARD bool is_directory(const path& _Target);
+
+    // checks if entries are invalidated by the system watcher, otherwise only _Ttl limits their age
+    _NODISCARD bool is_watching() const noexcept;
+
+    // returns the number of lookups that had to ask the system
+    _NODISCARD uintmax_t misses() const noexcept;
+
+private:
+    // returns true and sets _Info if _Target exists, the result may come from the cache
+    _NODISCARD bool _Lookup(const path& _Target, file_info& _Info);
+
+    _STD unique_ptr<_Status_cache_state> _Mystate; // shards, counters and the watcher
+};
+
+// ENUM CLASS directory_options
+enum class _FILESYSTEM_API directory_options : unsigned int {
+    none       = 0x0, // only names and types, nothing more is queried
+    fetch_info = 0x1 // fills directory_entry::info of each entry (links aren't followed)
+};
+
+_BITOPS(directory_options)
+
+// STRUCT directory_entry
+struct _FILESYSTEM_API directory_entry final { // one entry of the directory, as returned by the system
+    path name; // relative to the iterated directory
+    file_type type; // links aren't followed
+    file_info info; // valid only if has_info is true
+    bool has_info; // true if directory_options::fetch_info was used and the entry still existed and was accessible
+};
+
+// STRUCT _Directory_iterator_state
+struct _Directory_iterator_state;
+
+// CLASS directory_iterator
+class _FILESYSTEM_API directory_iterator { // reads entries one by one, "." and ".." are skipped
+public:
+    using iterator_category = _STD input_iterator_tag;
+    using value_type        = directory_entry;
+    using difference_type   = ptrdiff_t;
+    using pointer           = const directory_entry*;
+    using reference         = const directory_entry&;
+
+    directory_iterator() noexcept; // end iterator
+    explicit directory_iterator(const path& _Target, const directory_options _Options = directory_options::none);
+    ~directory_iterator() noexcept;
+
+    directory_iterator(const directory_iterator&) noexcept            = default;
+    directory_iterator(directory_iterator&&) noexcept                 = default;
+    directory_iterator& operator=(const directory_iterator&) noexcept = default;
+    directory_iterator& operator=(directory_iterator&&) noexcept      = default;
+
+    _NODISCARD reference operator*() const noexcept;
+    _NODISCARD pointer operator->() const noexcept;
+
+    directory_iterator& operator++();
+    void operator++(int); // the previous entry is lost, copies share the position
+
+    _NODISCARD bool operator==(const directory_iterator& _Other) const noexcept;
+
+private:
+    // reads the next entry, becomes the end iterator if there are no more entries
+    void _Advance();
+
+    _STD shared_ptr<_Directory_iterator_state> _Mystate; // shared by copies, nullptr if end
+};
+
+// FUNCTION begin
+_FILESYSTEM_API _NODISCARD directory_iterator begin(directory_iterator _Iter) noexcept;
+
+// FUNCTION end
+_FILESYSTEM_API _NODISCARD directory_iterator end(const directory_iterator&) noexcept;
+
+// STRUCT extension_usage
+struct _FILESYSTEM_API extension_usage final { // space taken by files with the same extension
+    uintmax_t files;
+    uintmax_t size;
+    uintmax_t allocation_size;
+};
+
+// STRUCT disk_usage
+struct _FILESYSTEM_API disk_usage final { // space taken by a directory tree
+    uintmax_t size; // apparent bytes of all files
+    uintmax_t allocation_size; // bytes taken on the disk by all files and directories
+    uintmax_t files; // everything but directories, hard links are counted once
+    uintmax_t directories; // junctions are counted as directories, but aren't entered
+    _STD unordered_map<path, extension_usage, path_hash, path_equal> extensions; // files without extension use ""
+};
+
+// FUNCTION directory_usage
+// sums the space taken by everything below _Root, links aren't followed, see recursive_walk() for _Threads,
+// entries and directories that can't be read are left out
+_FILESYSTEM_API _NODISCARD disk_usage directory_usage(const path& _Root, const size_t _Threads = 0);
+
 // FUNCTION _Is_directory
 // returns true if _Target is directory/symlink/junction
-_FILESYSTEM_API _NODISCARD bool _Is_directory(const file_status _Status) noexcept;
+_FILESYSTEM_API _NODISCARD bool _Is_directory(const file_status& _Status) noexcept;
 _FILESYSTEM_API _NODISCARD bool _Is_directory(const path& _Target) noexcept;
 
 // FUNCTION is_directory
-_FILESYSTEM_API _NODISCARD bool is_directory(const file_status _Status) noexcept;
+_FILESYSTEM_API _NODISCARD bool is_directory(const file_status& _Status) noexcept;
 _FILESYSTEM_API _NODISCARD bool is_directory(const path& _Target) noexcept;
 
 // FUNCTION is_empty
 _FILESYSTEM_API _NODISCARD bool is_empty(const path& _Target);
 
 // FUNCTION is_junction
-_FILESYSTEM_API _NODISCARD bool is_junction(const file_status _Status) noexcept;
+_FILESYSTEM_API _NODISCARD bool is_junction(const file_status& _Status) noexcept;
 _FILESYSTEM_API _NODISCARD bool is_junction(const path& _Target) noexcept;
 
 // FUNCTION is_other
-_FILESYSTEM_API _NODISCARD bool is_other(const file_status _Status) noexcept;
+_FILESYSTEM_API _NODISCARD bool is_other(const file_status& _Status) noexcept;
 _FILESYSTEM_API _NODISCARD bool is_other(const path& _Target) noexcept;
 
 // FUNCTION is_regular_file
-_FILESYSTEM_API _NODISCARD bool is_regular_file(const file_status _Status) noexcept;
+_FILESYSTEM_API _NODISCARD bool is_regular_file(const file_status& _Status) noexcept;
 _FILESYSTEM_API _NODISCARD bool is_regular_file(const path& _Target) noexcept;
 
 // FUNCTION is_symlink
-_FILESYSTEM_API _NODISCARD bool is_symlink(const file_status _Status) noexcept;
+_FILESYSTEM_API _NODISCARD bool is_symlink(const file_status& _Status) noexcept;
 _FILESYSTEM_API _NODISCARD bool is_symlink(const path& _Target) noexcept;
 
 // FUNCTION junction_status
 _FILESYSTEM_API _NODISCARD file_status junction_status(const path& _Target) noexcept;
 
 // FUNCTION last_access_time
-_FILESYSTEM_API _NODISCARD file_time last_access_time(const path& _Target);
+_FILESYSTEM_API _NODISCARD file_clock::time_point last_access_time(const path& _Target);
 
 // FUNCTION last_write_time
-_FILESYSTEM_API _NODISCARD file_time last_write_time(const path& _Target);
+_FILESYSTEM_API _NODISCARD file_clock::time_point last_write_time(const path& _Target);
 
 // FUNCTION lines_count
 _FILESYSTEM_API _NODISCARD uintmax_t lines_count(const path& _Target);
@@ -996,6 +1930,7 @@ _FILESYSTEM_API _NODISCARD uintmax_t lines_count(const path& _Target);
 // Functions that reads content from file (read_all(), read_back(), read_front() and read_inside())
 // are using string as return type. Don't use path because it accepts only 260 characters.
 // If you want to use they in other basic_string return type, just use _Convert_narrow_to_wide() or _Convert_narrow_to_utf().
+// The content is not validated, use is_valid_utf8() to check that it's UTF-8 text.
 
 // FUNCTION read_all
 _FILESYSTEM_API _NODISCARD vector<string> read_all(const path& _Target);
@@ -1012,12 +1947,48 @@ _FILESYSTEM_API _NODISCARD string read_inside(const path& _Target, const uintmax
 // FUNCTION read_junction
 _FILESYSTEM_API _NODISCARD path read_junction(const path& _Target);
 
+#if _HAS_WINDOWS
 // FUNCTION read_shortcut
 _FILESYSTEM_API _NODISCARD path read_shortcut(const path& _Target);
+#endif // _HAS_WINDOWS
 
 // FUNCTION read_symlink
 _FILESYSTEM_API _NODISCARD path read_symlink(const path& _Target);
 
+// ENUM CLASS walk_action
+enum class _FILESYSTEM_API walk_action : unsigned char {
+    proceed, // enters the directory, the same as skip for other types
+    skip, // doesn't enter the directory
+    stop // finishes the walk as soon as possible
+};
+
+// STRUCT walk_entry
+struct _FILESYSTEM_API walk_entry final { // one entry found by recursive_walk()
+    path target; // the root joined with the names of all parents and the entry
+    file_type type; // links aren't followed
+    file_info info; // valid only if has_info is true
+    bool has_info; // true if walk_options::fetch_info was set and the entry still existed and was accessible
+    size_t depth; // 0 for entries directly inside the root
+};
+
+// STRUCT walk_options
+struct _FILESYSTEM_API walk_options final {
+    size_t max_depth       = static_cast<size_t>(-1); // entries deeper than max_depth aren't visited
+    size_t threads         = 0; // 0 means as many as the hardware supports
+    bool fetch_info        = false; // fills walk_entry::info of each entry
+    bool follow_symlinks   = false; // enters symbolic links to directories, cycles are detected by file_id
+    bool follow_junctions  = false; // enters junctions, cycles are detected by file_id (Windows only)
+    bool skip_inaccessible = false; // visits unreadable entries without info and doesn't enter them, doesn't throw
+};
+
+// FUNCTION recursive_walk
+// Visits every entry below _Root (not _Root itself). Subdirectories are shared by a work-stealing pool of threads,
+// so _Visitor is called concurrently and in no particular order. An exception from _Visitor stops the walk
+// and is rethrown by recursive_walk(). Entries whose path would be longer than _Max_path are skipped.
+// Without walk_options::skip_inaccessible, an unreadable directory or entry info stops the walk the same way.
+_FILESYSTEM_API void recursive_walk(const path& _Root, const _STD function<walk_action(const walk_entry&)>& _Visitor,
+    const walk_options& _Options = walk_options{});
+
 // FUNCTION remove
 _FILESYSTEM_API _NODISCARD bool remove(const path& _Path);
 
@@ -1040,6 +2011,7 @@ _FILESYSTEM_API _NODISCARD bool rename(const path& _Old, const path& _New);
 // FUNCTION resize_file
 _FILESYSTEM_API _NODISCARD bool resize_file(const path& _Target, const size_t _Newsize);
 
+#if _HAS_WINDOWS
 namespace experimental {
     // STRUCT shortcut_data
     struct _FILESYSTEM_API _FILESYSTEM_DEPRECATED_SHORTCUT_PARAMETERS shortcut_data final { // warinig C6001 if not defined
@@ -1059,6 +2031,7 @@ namespace experimental {
     _FILESYSTEM_API _NODISCARD _FILESYSTEM_DEPRECATED_SHORTCUT_PARAMETERS bool shortcut_parameters(
         const path& _Target, shortcut_data* const _Params);
 } // experimental
+#endif // _HAS_WINDOWS
 
 // STRUCT disk_space
 struct _FILESYSTEM_API disk_space final {
@@ -1073,8 +2046,15 @@ _FILESYSTEM_API _NODISCARD disk_space space(const path& _Path);
 // FUNCTION status
 _FILESYSTEM_API _NODISCARD file_status status(const path& _Target) noexcept;
 
+// FUNCTION statuses
+// Gets info() of every target in parallel, _Results[_Idx] belongs to _Targets[_Idx]. Missing targets get
+// file_type::not_found and targets that couldn't be checked get file_type::none, nothing is thrown for them.
+// _Threads is the number of workers (including the calling thread), 0 selects it automatically.
+_FILESYSTEM_API void statuses(const span<const path> _Targets, const span<file_info> _Results, const size_t _Threads = 0);
+_FILESYSTEM_API _NODISCARD vector<file_info> statuses(const span<const path> _Targets, const size_t _Threads = 0);
+
 // FUNCTION status_known
-_FILESYSTEM_API _NODISCARD bool status_known(const file_status _Status) noexcept;
+_FILESYSTEM_API _NODISCARD bool status_known(const file_status& _Status) noexcept;
 _FILESYSTEM_API _NODISCARD bool status_known(const path& _Target) noexcept;
 
 // FUNCTION symlink_status
@@ -1083,23 +2063,63 @@ _FILESYSTEM_API _NODISCARD file_status symlink_status(const path& _Target) noexc
 // FUNCTION temp_directory_path
 _FILESYSTEM_API _NODISCARD path temp_directory_path();
 
+// FUNCTION to_local_time
+// converts _Time to the calendar time in the user time zone, much slower than comparing time points
+_FILESYSTEM_API _NODISCARD file_time to_local_time(const file_clock::time_point _Time);
+
+// ENUM CLASS text_encoding
+enum class _FILESYSTEM_API text_encoding : unsigned char {
+    detect, // source only, encoding from the BOM (UTF-8 if there is no BOM)
+    utf8,
+    utf16le,
+    utf16be,
+    utf32le,
+    utf32be
+};
+
+// FUNCTION transcode_file
+// Converts the text in _From to _Target encoding and writes it to _To, chunk by chunk (any file size).
+// A BOM that matches _Source is never copied, _Write_bom adds the BOM of _Target.
+// _To is replaced only on success, so _From and _To may be the same file.
+_FILESYSTEM_API _NODISCARD bool transcode_file(const path& _From, const path& _To, const text_encoding _Source,
+    const text_encoding _Target, const bool _Write_bom = false);
+
 // FUNCTION TEMPLATE write_back
 template <class _CharTy>
-_FILESYSTEM_API _NODISCARD constexpr bool write_back(const path& _Target, const _CharTy* const _Writable);
+_FILESYSTEM_API _NODISCARD bool write_back(const path& _Target, const _CharTy* const _Writable);
 
 // FUNCTION TEMPLATE write_front
 template <class _CharTy>
-_FILESYSTEM_API _NODISCARD constexpr bool write_front(const path& _Target, const _CharTy* const _Writable);
+_FILESYSTEM_API _NODISCARD bool write_front(const path& _Target, const _CharTy* const _Writable);
 
 // FUNCTION TEMPLATE write_inside
 template <class _CharTy>
-_FILESYSTEM_API _NODISCARD constexpr bool write_inside(const path& _Target, const _CharTy* const _Writable, const uintmax_t _Line);
+_FILESYSTEM_API _NODISCARD bool write_inside(const path& _Target, const _CharTy* const _Writable, const uintmax_t _Line);
 
 // FUNCTION TEMPLATE write_instead
 template <class _CharTy>
-_FILESYSTEM_API _NODISCARD constexpr bool write_instead(const path& _Target, const _CharTy* const _Writable, const uintmax_t _Line);
+_FILESYSTEM_API _NODISCARD bool write_instead(const path& _Target, const _CharTy* const _Writable, const uintmax_t _Line);
 _FILESYSTEM_END
 
+namespace std {
+    // STRUCT hash<path>
+    template <>
+    struct hash<_FILESYSTEM path> {
+        _NODISCARD size_t operator()(const _FILESYSTEM path& _Path) const noexcept {
+            return _Path.hash();
+        }
+    };
+
+    // STRUCT hash<path_view>
+    template <>
+    struct hash<_FILESYSTEM path_view> {
+        _NODISCARD size_t operator()(const _FILESYSTEM path_view _Path) const noexcept {
+            return _Path.hash();
+        }
+    };
+} // namespace std
+
+#if _HAS_WINDOWS
 #pragma warning(pop)
-#endif // !_HAS_WINDOWS
+#endif // _HAS_WINDOWS
 #endif // _FILESYSTEM_HPP_
\ No newline at end of file
@@ -7,6 +7,20 @@
 #ifndef _FILESYSTEM_FRAMEWORK_HPP_
 #define _FILESYSTEM_FRAMEWORK_HPP_
 
+#ifdef _WIN32
 #define WIN32_LEAN_AND_MEAN
 #include <Windows.h>
+#else // ^^^ _WIN32 ^^^ / vvv !_WIN32 vvv
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/stat.h>
+#include <sys/statvfs.h>
+#include <sys/syscall.h>
+#include <sys/types.h>
+#include <time.h>
+#include <unistd.h>
+#endif // _WIN32
 #endif // _FILESYSTEM_FRAMEWORK_HPP_
\ No newline at end of file
@@ -0,0 +1,280 @@
+// filesystem_internal.hpp
+
+// Copyright (c) Mateusz Jandura. All rights reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+#ifndef _FILESYSTEM_INTERNAL_HPP_
+#define _FILESYSTEM_INTERNAL_HPP_
+
+#include <filesystem_framework.hpp>
+#include <filesystem.hpp>
+
+// Helpers shared by translation units of filesystem.dll/libfilesystem.so.
+// Don't include this header in programs that use filesystem.
+
+// SSE2 is a part of every x64 processor, on x86 only if the compiler was told to use it
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define _FILESYSTEM_SSE2 1
+#include <emmintrin.h>
+#else // ^^^ SSE2 available ^^^ / vvv SSE2 not available vvv
+#define _FILESYSTEM_SSE2 0
+#endif // SSE2 available
+
+_FILESYSTEM_BEGIN
+// CONSTANT _Transcode_error
+inline constexpr size_t _Transcode_error = static_cast<size_t>(-1); // returned if the input is not valid Unicode
+
+// FUNCTION TEMPLATE _Utf8_to_utf
+// Converts UTF-8 to UTF-16 (2-byte _Elem) or UTF-32 (4-byte _Elem), returns the number of written code units.
+// _Dest must hold at least _Size code units. Invalid sequences fail if _Strict, otherwise become U+FFFD.
+template <class _Elem>
+_NODISCARD size_t _Utf8_to_utf(
+    const char* const _First, const size_t _Size, _Elem* const _Dest, const bool _Strict) noexcept;
+
+// FUNCTION TEMPLATE _Utf_to_utf8
+// Converts UTF-16 (2-byte _Elem) or UTF-32 (4-byte _Elem) to UTF-8, returns the number of written bytes.
+// _Dest must hold at least 3 (UTF-16) or 4 (UTF-32) bytes per code unit.
+template <class _Elem>
+_NODISCARD size_t _Utf_to_utf8(
+    const _Elem* const _First, const size_t _Size, char* const _Dest, const bool _Strict) noexcept;
+
+// STRUCT _File_id_hash
+struct _File_id_hash { // hashes all bytes of file_id, used to find directories and hard links seen before
+    _NODISCARD size_t operator()(const file_id& _Id) const noexcept {
+        return _STD hash<string_view>{}(string_view{reinterpret_cast<const char*>(&_Id), sizeof(file_id)});
+    }
+};
+
+// STRUCT _File_id_equal
+struct _File_id_equal {
+    _NODISCARD bool operator()(const file_id& _Left, const file_id& _Right) const noexcept {
+        return _CSTD memcmp(&_Left, &_Right, sizeof(file_id)) == 0;
+    }
+};
+
+// FUNCTION _Try_info
+// The same as info(), but returns false instead of throwing if _Target doesn't exist.
+_NODISCARD bool _Try_info(const path& _Target, const bool _Follow_links, file_info& _Result);
+_FILESYSTEM_END
+
+#if _HAS_WINDOWS
+_FILESYSTEM_BEGIN
+// FUNCTION _Handle_info
+// The same as info(), but for an open handle, returns false if any query failed.
+_NODISCARD bool _Handle_info(const HANDLE _Handle, file_info& _Result) noexcept;
+
+// FUNCTION _File_type_from_find_data
+_NODISCARD inline file_type _File_type_from_find_data(const WIN32_FIND_DATAW& _Data) noexcept {
+    // dwReserved0 holds the reparse tag if the entry is a reparse point, no other call is needed
+    if ((_Data.dwFileAttributes & FILE_ATTRIBUTE_REPARSE_POINT) != 0) {
+        if (_Data.dwReserved0 == static_cast<unsigned long>(file_reparse_tag::mount_point)) {
+            return file_type::junction;
+        }
+
+        if (_Data.dwReserved0 == static_cast<unsigned long>(file_reparse_tag::symlink)) {
+            return file_type::symlink;
+        }
+
+        // all others are file or directory types
+    }
+
+    return (_Data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) != 0 ? file_type::directory : file_type::regular;
+}
+_FILESYSTEM_END
+#endif // _HAS_WINDOWS
+
+#if !_HAS_WINDOWS
+#include <limits>
+#include <memory>
+
+_FILESYSTEM_BEGIN
+// CLASS _Unique_descriptor
+class _Unique_descriptor { // owns a file descriptor, closes it when destroyed
+public:
+    _Unique_descriptor() noexcept : _Myfd(-1) {}
+
+    explicit _Unique_descriptor(const int _Fd) noexcept : _Myfd(_Fd) {}
+
+    _Unique_descriptor(_Unique_descriptor&& _Other) noexcept : _Myfd(_Other._Release()) {}
+
+    ~_Unique_descriptor() noexcept {
+        _Close();
+    }
+
+    _Unique_descriptor(const _Unique_descriptor&)            = delete;
+    _Unique_descriptor& operator=(const _Unique_descriptor&) = delete;
+
+    _Unique_descriptor& operator=(_Unique_descriptor&& _Other) noexcept {
+        if (this != __builtin_addressof(_Other)) { // avoid closing own descriptor
+            _Close();
+            _Myfd = _Other._Release();
+        }
+
+        return *this;
+    }
+
+    // closes the current descriptor (if has)
+    void _Close() noexcept {
+        if (_Myfd != -1) {
+            (void) ::close(_Myfd);
+            _Myfd = -1;
+        }
+    }
+
+    // returns the current descriptor
+    _NODISCARD int _Get() const noexcept {
+        return _Myfd;
+    }
+
+    // gives up the ownership of the current descriptor
+    _NODISCARD int _Release() noexcept {
+        const int _Fd{_Myfd};
+        _Myfd = -1;
+        return _Fd;
+    }
+
+private:
+    int _Myfd; // owned descriptor or -1
+};
+
+// STRUCT _Linux_dirent64
+struct _Linux_dirent64 { // copy of linux_dirent64
+    uint64_t _Ino; // d_ino
+    int64_t _Off; // d_off
+    unsigned short _Reclen; // d_reclen
+    unsigned char _Type; // d_type
+    char _Name[1]; // d_name (null-terminated, may be longer than 1 character)
+};
+
+// CLASS _Directory_reader
+class _Directory_reader { // reads directory entries directly with getdents64(), skips "." and ".."
+public:
+    explicit _Directory_reader(const int _Fd)
+        : _Myfd(_Fd), _Mybuf(new char[_Buffer_size]), _Mysize(0), _Mypos(0) {}
+
+    _Directory_reader(const _Directory_reader&)            = delete;
+    _Directory_reader& operator=(const _Directory_reader&) = delete;
+
+    // reads the next entry, returns nullptr if there are no more entries
+    _NODISCARD const _Linux_dirent64* _Next() {
+        for (;;) {
+            if (_Mypos >= _Mysize) { // buffer exhausted, ask the kernel for the next batch
+                _Mysize = ::syscall(SYS_getdents64, _Myfd, _Mybuf.get(), _Buffer_size);
+                _Mypos  = 0;
+                if (_Mysize == 0) { // end of the directory
+                    return nullptr;
+                }
+
+                if (_Mysize < 0) {
+                    _Throw_fs_error("failed to read the directory", error_type::runtime_error, "_Next");
+                }
+            }
+
+            const auto _Entry{reinterpret_cast<const _Linux_dirent64*>(_Mybuf.get() + _Mypos)};
+            _Mypos += _Entry->_Reclen;
+            if (!_Is_dot_or_dot_dot(_Entry->_Name)) {
+                return _Entry;
+            }
+        }
+    }
+
+private:
+    // checks if _Name is "." or ".."
+    _NODISCARD static bool _Is_dot_or_dot_dot(const char* const _Name) noexcept {
+        return _Name[0] == '.' && (_Name[1] == '\0' || (_Name[1] == '.' && _Name[2] == '\0'));
+    }
+
+    static constexpr size_t _Buffer_size = 32768; // enough for a few hundred entries per system call
+
+    int _Myfd; // directory descriptor (not owned)
+    _STD unique_ptr<char[]> _Mybuf; // buffer for getdents64()
+    long _Mysize; // count of valid bytes in _Mybuf
+    long _Mypos; // position of the next entry in _Mybuf
+};
+
+// FUNCTION _Open_directory
+_NODISCARD inline int _Open_directory(const int _Dirfd, const char* const _Name) noexcept {
+    // never follow symbolic links, entries found inside a directory should be treated as links, not as directories
+    return ::openat(_Dirfd, _Name, O_RDONLY | O_DIRECTORY | O_NOFOLLOW | O_CLOEXEC);
+}
+
+// FUNCTION _File_type_from_mode
+_NODISCARD inline file_type _File_type_from_mode(const mode_t _Mode) noexcept {
+    switch (_Mode & S_IFMT) {
+    case S_IFDIR:
+        return file_type::directory;
+    case S_IFREG:
+        return file_type::regular;
+    case S_IFLNK:
+        return file_type::symlink;
+    case S_IFBLK:
+        return file_type::block;
+    case S_IFCHR:
+        return file_type::character;
+    case S_IFIFO:
+        return file_type::fifo;
+    case S_IFSOCK:
+        return file_type::socket;
+    default: // never happens
+        return file_type::none;
+    }
+}
+
+// FUNCTION _Try_info_at
+// The same as _Try_info(), but _Name is relative to the directory _Dirfd (or to the current one if AT_FDCWD).
+// An empty _Name means the file open as _Dirfd.
+_NODISCARD bool _Try_info_at(const int _Dirfd, const char* const _Name, const bool _Follow_links, file_info& _Result);
+
+// FUNCTION _File_type_from_dirent
+_NODISCARD inline file_type _File_type_from_dirent(const int _Dirfd, const _Linux_dirent64& _Entry) noexcept {
+    // most file systems fill d_type, ask for the mode only if they don't
+    switch (_Entry._Type) {
+    case DT_DIR:
+        return file_type::directory;
+    case DT_REG:
+        return file_type::regular;
+    case DT_LNK:
+        return file_type::symlink;
+    case DT_BLK:
+        return file_type::block;
+    case DT_CHR:
+        return file_type::character;
+    case DT_FIFO:
+        return file_type::fifo;
+    case DT_SOCK:
+        return file_type::socket;
+    default: // DT_UNKNOWN
+        struct stat _Stat;
+        if (::fstatat(_Dirfd, _Entry._Name, &_Stat, AT_SYMLINK_NOFOLLOW) != 0) { // removed in the meantime
+            return file_type::not_found;
+        }
+
+        return _File_type_from_mode(_Stat.st_mode);
+    }
+}
+
+// CONSTANT _Timespec_min_seconds
+inline constexpr int64_t _Timespec_min_seconds = (_STD numeric_limits<int64_t>::min)() / 1'000'000'000;
+
+// CONSTANT _Timespec_max_seconds
+inline constexpr int64_t _Timespec_max_seconds = (_STD numeric_limits<int64_t>::max)() / 1'000'000'000;
+
+// FUNCTION _File_clock_from_timespec
+_NODISCARD constexpr file_clock::time_point _File_clock_from_timespec(const int64_t _Sec, const uint32_t _Nsec) noexcept {
+    // both count from the Unix epoch, only the unit differs, but file_clock covers only the years 1678-2262,
+    // times outside are clamped to its limits (the same as _File_clock_from_filetime() on Windows)
+    if (_Sec < _Timespec_min_seconds) {
+        return (file_clock::time_point::min)();
+    }
+
+    if (_Sec > _Timespec_max_seconds || (_Sec == _Timespec_max_seconds
+        && _Nsec > static_cast<uint32_t>((_STD numeric_limits<int64_t>::max)() % 1'000'000'000))) {
+        return (file_clock::time_point::max)();
+    }
+
+    return file_clock::time_point{file_clock::duration{_Sec * 1'000'000'000 + static_cast<int64_t>(_Nsec)}};
+}
+_FILESYSTEM_END
+#endif // !_HAS_WINDOWS
+#endif // _FILESYSTEM_INTERNAL_HPP_
\ No newline at end of file
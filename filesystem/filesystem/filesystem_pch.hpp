@@ -9,4 +9,5 @@
 
 #include <filesystem_framework.hpp>
 #include <filesystem.hpp>
+#include <filesystem_internal.hpp>
 #endif // _FILESYSTEM_PCH_HPP_
\ No newline at end of file
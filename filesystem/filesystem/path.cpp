@@ -6,14 +6,11 @@
 #include <filesystem_pch.hpp>
 #include <filesystem.hpp>
 
-#if !_HAS_WINDOWS
-#pragma message("The contents of <path.cpp> are available only with Windows 10.")
-#else // ^^^ !_HAS_WINDOWS ^^^ / vvv _HAS_WINDOWS vvv
 
 _FILESYSTEM_BEGIN
 // FUNCTION TEMPLATE operator>>
 template <class _Elem, class _Traits>
-_NODISCARD constexpr basic_istream<_Elem, _Traits>& operator>>(basic_istream<_Elem, _Traits>& _Istr, path& _Path) {
+_NODISCARD basic_istream<_Elem, _Traits>& operator>>(basic_istream<_Elem, _Traits>& _Istr, path& _Path) {
     basic_string<_Elem, _Traits, allocator<_Elem>> _Input;
     _Istr >> _Input;
     _Path = _STD move(_Input);
@@ -25,7 +22,7 @@ template _FILESYSTEM_API _NODISCARD wistream& operator>>(wistream&, path&);
 
 // FUNCTION TEMPLATE operator<<
 template <class _Elem, class _Traits>
-_NODISCARD constexpr basic_ostream<_Elem, _Traits>& operator<<(basic_ostream<_Elem, _Traits>& _Ostr, const path& _Path) {
+_NODISCARD basic_ostream<_Elem, _Traits>& operator<<(basic_ostream<_Elem, _Traits>& _Ostr, const path& _Path) {
     // current C++ standard supports only char and wchar_t streams
     if constexpr (_STD is_same_v<_Elem, char>) {
         _Ostr << _Path.generic_string();
@@ -41,12 +38,16 @@ template _FILESYSTEM_API _NODISCARD wostream& operator<<(wostream&, const path&)
 
 // FUNCTION TEMPLATE operator+
 _NODISCARD path operator+(const path& _Left, const path& _Right) {
-    return path(_Left.generic_string() + _Right.generic_string());
+    path _Result{_Left};
+    _Result += _Right;
+    return _Result;
 }
 
 template <class _CharTy>
-_NODISCARD constexpr path operator+(const path& _Left, const _CharTy* const _Right) {
-    return path(_Left.generic_string() + _Convert_to_narrow<_CharTy, char_traits<_CharTy>>(_Right));
+_NODISCARD path operator+(const path& _Left, const _CharTy* const _Right) {
+    path _Result{_Left};
+    _Result += _Right;
+    return _Result;
 }
 
 template _FILESYSTEM_API _NODISCARD path operator+(const path&, const char* const);
@@ -56,8 +57,10 @@ template _FILESYSTEM_API _NODISCARD path operator+(const path&, const char32_t*
 template _FILESYSTEM_API _NODISCARD path operator+(const path&, const wchar_t* const);
 
 template <class _CharTy>
-_NODISCARD constexpr path operator+(const _CharTy* const _Left, const path& _Right) {
-    return path(_Convert_to_narrow<_CharTy, char_traits<_CharTy>>(_Left) + _Right.generic_string());
+_NODISCARD path operator+(const _CharTy* const _Left, const path& _Right) {
+    path _Result{_Left};
+    _Result += _Right;
+    return _Result;
 }
 
 template _FILESYSTEM_API _NODISCARD path operator+(const char* const, const path&);
@@ -67,8 +70,10 @@ template _FILESYSTEM_API _NODISCARD path operator+(const char32_t* const, const
 template _FILESYSTEM_API _NODISCARD path operator+(const wchar_t* const, const path&);
 
 template <class _Elem, class _Traits, class _Alloc>
-_NODISCARD constexpr path operator+(const path& _Left, const basic_string<_Elem, _Traits, _Alloc>& _Right) {
-    return path(_Left.generic_string() + _Convert_to_narrow<_Elem, _Traits>(_Right.data()));
+_NODISCARD path operator+(const path& _Left, const basic_string<_Elem, _Traits, _Alloc>& _Right) {
+    path _Result{_Left};
+    _Result += _Right;
+    return _Result;
 }
 
 template _FILESYSTEM_API _NODISCARD path operator+(const path&, const string&);
@@ -78,8 +83,10 @@ template _FILESYSTEM_API _NODISCARD path operator+(const path&, const u32string&
 template _FILESYSTEM_API _NODISCARD path operator+(const path&, const wstring&);
 
 template <class _Elem, class _Traits, class _Alloc>
-_NODISCARD constexpr path operator+(const basic_string<_Elem, _Traits, _Alloc>& _Left, const path& _Right) {
-    return path(_Convert_to_narrow<_Elem, _Traits>(_Left.data()) + _Right.generic_string());
+_NODISCARD path operator+(const basic_string<_Elem, _Traits, _Alloc>& _Left, const path& _Right) {
+    path _Result{_Left};
+    _Result += _Right;
+    return _Result;
 }
 
 template _FILESYSTEM_API _NODISCARD path operator+(const string&, const path&);
@@ -88,13 +95,160 @@ template _FILESYSTEM_API _NODISCARD path operator+(const u16string&, const path&
 template _FILESYSTEM_API _NODISCARD path operator+(const u32string&, const path&);
 template _FILESYSTEM_API _NODISCARD path operator+(const wstring&, const path&);
 
+// FUNCTION _Make_path_index
+_NODISCARD _Path_index _Make_path_index(const string_view _Text) noexcept {
+    _Path_index _Index;
+    bool _In_component{false};
+    size_t _Idx{0};
+#if _FILESYSTEM_SSE2
+    const __m128i _Expected{_mm_set1_epi8(_Expected_slash)};
+    const __m128i _Unexpected{_mm_set1_epi8(_Unexpected_slash)};
+    const __m128i _Dot{_mm_set1_epi8('.')};
+    for (; _Text.size() - _Idx >= 16; _Idx += 16) { // classify 16 characters at a time
+        const __m128i _Chunk{_mm_loadu_si128(reinterpret_cast<const __m128i*>(_Text.data() + _Idx))};
+        const unsigned int _Expected_mask{static_cast<unsigned int>(_mm_movemask_epi8(_mm_cmpeq_epi8(_Chunk, _Expected)))};
+        const unsigned int _Unexpected_mask{_Has_unexpected_slash
+            ? static_cast<unsigned int>(_mm_movemask_epi8(_mm_cmpeq_epi8(_Chunk, _Unexpected))) : 0U};
+        const unsigned int _Dot_mask{static_cast<unsigned int>(_mm_movemask_epi8(_mm_cmpeq_epi8(_Chunk, _Dot)))};
+        if (_Expected_mask != 0) {
+            if (_Index._First_slash == _Path_index::npos) {
+                _Index._First_slash = _Idx + _STD countr_zero(_Expected_mask);
+            }
+
+            _Index._Last_slash = _Idx + _STD bit_width(_Expected_mask) - 1;
+        }
+
+        if (_Dot_mask != 0) {
+            if (_Index._First_dot == _Path_index::npos) {
+                _Index._First_dot = _Idx + _STD countr_zero(_Dot_mask);
+            }
+
+            _Index._Last_dot = _Idx + _STD bit_width(_Dot_mask) - 1;
+        }
+
+        // every character that is not a slash, but follows a slash (or the beginning), starts a component
+        const unsigned int _Slashes{_Expected_mask | _Unexpected_mask};
+        const unsigned int _Starts{~_Slashes & ((_Slashes << 1) | (_In_component ? 0U : 1U)) & 0xFFFFU};
+        _Index._Count     += static_cast<size_t>(_STD popcount(_Starts));
+        _Index._Unexpected = _Index._Unexpected || _Unexpected_mask != 0;
+        _In_component      = (_Slashes & 0x8000U) == 0;
+    }
+#endif // _FILESYSTEM_SSE2
+
+    _Finish_path_index(_Index, _Text, _Idx, _In_component);
+    return _Index;
+}
+
+// FUNCTION path_component_iterator::path_component_iterator
+path_component_iterator::path_component_iterator() noexcept
+    : _Myfirst(nullptr), _Mylast(nullptr), _Mybegin(nullptr), _Myend(nullptr) {}
+
+path_component_iterator::path_component_iterator(
+    const char* const _First, const char* const _Last, const char* const _Pos) noexcept
+    : _Myfirst(_First), _Mylast(_Last), _Mybegin(_Pos), _Myend(_Pos) {
+    if (_Pos != _Last) { // find the first component
+        ++*this;
+    }
+}
+
+// FUNCTION path_component_iterator::operator*
+_NODISCARD path_view path_component_iterator::operator*() const noexcept {
+    return component();
+}
+
+// FUNCTION path_component_iterator::operator++
+path_component_iterator& path_component_iterator::operator++() noexcept {
+    _Mybegin = _Myend;
+    while (_Mybegin != _Mylast && _Is_slash(*_Mybegin)) { // skip separators (repeated too)
+        ++_Mybegin;
+    }
+
+    _Myend = _Mybegin;
+    while (_Myend != _Mylast && !_Is_slash(*_Myend)) {
+        ++_Myend;
+    }
+
+    return *this;
+}
+
+path_component_iterator path_component_iterator::operator++(int) noexcept {
+    path_component_iterator _Temp{*this};
+    ++*this;
+    return _Temp;
+}
+
+// FUNCTION path_component_iterator::operator--
+path_component_iterator& path_component_iterator::operator--() noexcept {
+    _Myend = _Mybegin;
+    while (_Myend != _Myfirst && _Is_slash(_Myend[-1])) { // skip separators (repeated too)
+        --_Myend;
+    }
+
+    _Mybegin = _Myend;
+    while (_Mybegin != _Myfirst && !_Is_slash(_Mybegin[-1])) {
+        --_Mybegin;
+    }
+
+    return *this;
+}
+
+path_component_iterator path_component_iterator::operator--(int) noexcept {
+    path_component_iterator _Temp{*this};
+    --*this;
+    return _Temp;
+}
+
+// FUNCTION path_component_iterator::operator==
+_NODISCARD bool path_component_iterator::operator==(const path_component_iterator& _Other) const noexcept {
+    return _Mybegin == _Other._Mybegin;
+}
+
+// FUNCTION path_component_iterator::operator!=
+_NODISCARD bool path_component_iterator::operator!=(const path_component_iterator& _Other) const noexcept {
+    return _Mybegin != _Other._Mybegin;
+}
+
+// FUNCTION path_component_iterator::component
+_NODISCARD string_view path_component_iterator::component() const noexcept {
+    return string_view{_Mybegin, static_cast<size_t>(_Myend - _Mybegin)};
+}
+
+// FUNCTION path_component_range::path_component_range
+path_component_range::path_component_range(
+    const path_component_iterator _First, const path_component_iterator _Last) noexcept
+    : _Myfirst(_First), _Mylast(_Last) {}
+
+// FUNCTION path_component_range::begin
+_NODISCARD path_component_iterator path_component_range::begin() const noexcept {
+    return _Myfirst;
+}
+
+// FUNCTION path_component_range::end
+_NODISCARD path_component_iterator path_component_range::end() const noexcept {
+    return _Mylast;
+}
+
+// FUNCTION path::path
+path::path() noexcept : _Mysize(0), _Myindex(), _Myhash(_Hash_path(string_view{})) {
+    _Mytext[0] = value_type(0);
+#if _HAS_WINDOWS
+    _Mynative[0]   = L'\0';
+    _Mynative_size = 0;
+#endif // _HAS_WINDOWS
+}
+
 // FUNCTION TEMPLATE path::path
 template <class _CharTy>
-path::path(const _CharTy* const _Source) {
+path::path(const _CharTy* const _Source) : _Mysize(0), _Myindex(), _Myhash(_Hash_path(string_view{})) {
     // _CharTy must be an character (char/char8_t/char16_t/char32_t/wchar_t) type
     static_assert(_Is_char_t<_CharTy>, "invalid character type");
-    _Mytext = _Convert_to_narrow<_CharTy, char_traits<_CharTy>>(_Source);
-    _Check_size();
+    if constexpr (_Is_narrow_char_t<_CharTy>) { // copy directly to the buffer
+        const string_view _Narrow{_Source};
+        _Check_encoding(_Narrow);
+        _Assign(_Narrow);
+    } else {
+        _Assign(_Convert_to_narrow<_CharTy, char_traits<_CharTy>>(_Source));
+    }
 }
 
 template _FILESYSTEM_API path::path(const char* const);
@@ -104,11 +258,18 @@ template _FILESYSTEM_API path::path(const char32_t* const);
 template _FILESYSTEM_API path::path(const wchar_t* const);
 
 template <class _Src>
-path::path(const _Src& _Source) {
+path::path(const _Src& _Source) : _Mysize(0), _Myindex(), _Myhash(_Hash_path(string_view{})) {
     // _Src must be an string (basic_string/basic_string_view) type
     static_assert(_Is_src_t<_Src>, "invalid string type");
-    _Mytext = _Convert_to_narrow<typename _Src::value_type, typename _Src::traits_type>(_Source.data());
-    _Check_size();
+    using _Elem   = typename _Src::value_type;
+    using _Traits = typename _Src::traits_type;
+    if constexpr (_Is_narrow_char_t<_Elem>) { // copy directly to the buffer
+        const string_view _Narrow{_Source};
+        _Check_encoding(_Narrow);
+        _Assign(_Narrow);
+    } else {
+        _Assign(_Convert_to_narrow<_Elem, _Traits>(basic_string_view<_Elem, _Traits>{_Source}));
+    }
 } 
 
 template _FILESYSTEM_API path::path(const string&);
@@ -123,19 +284,113 @@ template _FILESYSTEM_API path::path(const u16string_view&);
 template _FILESYSTEM_API path::path(const u32string_view&);
 template _FILESYSTEM_API path::path(const wstring_view&);
 
+path::path(const path_view _Source) : _Mysize(0), _Myindex(), _Myhash(_Hash_path(string_view{})) {
+    _Check_encoding(_Source.view());
+    _Assign(_Source.view());
+}
+
+path::path(const string_view _Text, const _Path_index& _Index, const size_t _Hash) noexcept
+    : _Mysize(_Text.size()), _Myindex(_Index), _Myhash(_Hash) {
+    // validated, normalized and indexed at compile time, so only copy (and on Windows convert) the text
+    _CSTD memcpy(_Mytext, _Text.data(), _Mysize);
+    _Mytext[_Mysize] = value_type(0);
+#if _HAS_WINDOWS
+    _Refresh_native();
+#endif // _HAS_WINDOWS
+}
+
+// FUNCTION path::_Text
+_NODISCARD string_view path::_Text() const noexcept {
+    return string_view{_Mytext, _Mysize};
+}
+
+// FUNCTION path::_Assign
+void path::_Assign(const string_view _Newtext) {
+    _Check_size(_Newtext.size());
+
+    // _Newtext may be a part of the current working path, so use memmove() instead of memcpy()
+    _CSTD memmove(_Mytext, _Newtext.data(), _Newtext.size());
+    _Mysize          = _Newtext.size();
+    _Mytext[_Mysize] = value_type(0);
+    _Reindex();
+}
+
+// FUNCTION path::_Append
+void path::_Append(const string_view _Added) {
+    _Check_size(_Mysize + _Added.size());
+    _CSTD memmove(_Mytext + _Mysize, _Added.data(), _Added.size());
+    _Mysize         += _Added.size();
+    _Mytext[_Mysize] = value_type(0);
+    _Reindex();
+}
+
+// FUNCTION path::_Extend
+void path::_Extend(const size_type _Old_size) noexcept {
+    // only the appended characters are indexed and converted, the hash covers the length, so it's computed again
+    _Finish_path_index(_Myindex, _Text(), _Old_size, false);
+    _Myhash = _Hash_path(_Text());
+#if _HAS_WINDOWS
+    _Mynative_size += _Utf8_to_utf(_Mytext + _Old_size, _Mysize - _Old_size, _Mynative + _Mynative_size, false);
+    _Mynative[_Mynative_size] = L'\0';
+#endif // _HAS_WINDOWS
+}
+
+// FUNCTION path::_Check_encoding
+void path::_Check_encoding(const string_view _Narrow) {
+#if _HAS_WINDOWS
+    // Windows names are UTF-16, a narrow path that is not valid UTF-8 cannot name any file
+    if (!is_valid_utf8(_Narrow)) {
+        _Throw_system_error("path", "invalid UTF-8", error_type::invalid_argument);
+    }
+#else // ^^^ _HAS_WINDOWS ^^^ / vvv !_HAS_WINDOWS vvv
+    (void) _Narrow; // Linux names are byte strings, every encoding is allowed
+#endif // _HAS_WINDOWS
+}
+
 // FUNCTION path::_Check_size
-constexpr void path::_Check_size() const {
-    // path cannot be longer than 260 characters
-    if (_Mytext.size() > _Max_path) {
+void path::_Check_size(const size_type _Newsize) {
+    // path cannot be longer than _Max_path characters, check it before writing to the buffer
+    if (_Newsize > _Max_path) {
         _Throw_system_error("_Check_size", "invalid length", error_type::length_error);
     }
 }
 
+// FUNCTION path::_Index
+_NODISCARD _Path_index path::_Index() const noexcept {
+    return _Myindex;
+}
+
+// FUNCTION path::_Reindex
+void path::_Reindex() noexcept {
+    _Myindex = _Make_path_index(_Text());
+    _Myhash  = _Hash_path(_Text());
+#if _HAS_WINDOWS
+    _Refresh_native(); // always up to date, so const functions never write and can be called from many threads
+#endif // _HAS_WINDOWS
+}
+
+#if _HAS_WINDOWS
+// FUNCTION path::_Refresh_native
+void path::_Refresh_native() noexcept {
+    // UTF-16 never needs more code units than UTF-8 needs bytes, so the buffer is always large enough.
+    // Invalid sequences are replaced with U+FFFD, the Win32 API will report them as not found.
+    _Mynative_size            = _Utf8_to_utf(_Mytext, _Mysize, _Mynative, false);
+    _Mynative[_Mynative_size] = L'\0';
+}
+#endif // _HAS_WINDOWS
+
 // FUNCTION path::operator=
 path& path::operator=(const path& _Source) {
     if (this != __builtin_addressof(_Source)) { // avoid assigning own value
-        _Mytext = _Source._Mytext;
-        _Check_size();
+        // the same as the copy constructor, but only the used part of the buffers is copied
+        _CSTD memcpy(_Mytext, _Source._Mytext, _Source._Mysize + 1);
+        _Mysize  = _Source._Mysize;
+        _Myindex = _Source._Myindex;
+        _Myhash  = _Source._Myhash;
+#if _HAS_WINDOWS
+        _CSTD memcpy(_Mynative, _Source._Mynative, (_Source._Mynative_size + 1) * sizeof(native_value_type));
+        _Mynative_size = _Source._Mynative_size;
+#endif // _HAS_WINDOWS
     }
     
     return *this;
@@ -145,8 +400,14 @@ template <class _CharTy>
 path& path::operator=(const _CharTy* const _Source) {
     // _CharTy must be an character (char/char8_t/char16_t/char32_t/wchar_t) type
     static_assert(_Is_char_t<_CharTy>, "invalid character type");
-    _Mytext = _Convert_to_narrow<_CharTy, char_traits<_CharTy>>(_Source);
-    _Check_size();
+    if constexpr (_Is_narrow_char_t<_CharTy>) { // copy directly to the buffer
+        const string_view _Narrow{_Source};
+        _Check_encoding(_Narrow);
+        _Assign(_Narrow);
+    } else {
+        _Assign(_Convert_to_narrow<_CharTy, char_traits<_CharTy>>(_Source));
+    }
+
     return *this;
 }
 
@@ -160,8 +421,16 @@ template<class _Src>
 path& path::operator=(const _Src& _Source) {
     // _Src must be an string (basic_string/basic_string_view) type
     static_assert(_Is_src_t<_Src>, "invalid string type");
-    _Mytext = _Convert_to_narrow<typename _Src::value_type, typename _Src::traits_type>(_Source.data());
-    _Check_size();
+    using _Elem   = typename _Src::value_type;
+    using _Traits = typename _Src::traits_type;
+    if constexpr (_Is_narrow_char_t<_Elem>) { // copy directly to the buffer
+        const string_view _Narrow{_Source};
+        _Check_encoding(_Narrow);
+        _Assign(_Narrow);
+    } else {
+        _Assign(_Convert_to_narrow<_Elem, _Traits>(basic_string_view<_Elem, _Traits>{_Source}));
+    }
+
     return *this;
 }
 
@@ -215,8 +484,7 @@ template _FILESYSTEM_API path& path::assign(const wstring_view&);
 // FUNCTION path::operator+=
 path& path::operator+=(const path& _Added) {
     if (this != __builtin_addressof(_Added)) { // avoid appending own value
-        _Mytext += _Added._Mytext;
-        _Check_size();
+        _Append(_Added._Text());
     }
 
     return *this;
@@ -226,8 +494,14 @@ template <class _CharTy>
 path& path::operator+=(const _CharTy* const _Added) {
     // _CharTy must be an character (char/char8_t/char16_t/char32_t/wchar_t) type
     static_assert(_Is_char_t<_CharTy>, "invalid character type");
-    _Mytext += _Convert_to_narrow<_CharTy, char_traits<_CharTy>>(_Added);
-    _Check_size();
+    if constexpr (_Is_narrow_char_t<_CharTy>) { // append directly to the buffer
+        const string_view _Narrow{_Added};
+        _Check_encoding(_Narrow);
+        _Append(_Narrow);
+    } else {
+        _Append(_Convert_to_narrow<_CharTy, char_traits<_CharTy>>(_Added));
+    }
+
     return *this;
 }
 
@@ -241,8 +515,16 @@ template <class _Src>
 path& path::operator+=(const _Src& _Added) {
     // _Src must be an string (basic_string/basic_string_view) type
     static_assert(_Is_src_t<_Src>, "invalid string type");
-    _Mytext += _Convert_to_narrow<typename _Src::value_type, typename _Src::traits_type>(_Added.data());
-    _Check_size();
+    using _Elem   = typename _Src::value_type;
+    using _Traits = typename _Src::traits_type;
+    if constexpr (_Is_narrow_char_t<_Elem>) { // append directly to the buffer
+        const string_view _Narrow{_Added};
+        _Check_encoding(_Narrow);
+        _Append(_Narrow);
+    } else {
+        _Append(_Convert_to_narrow<_Elem, _Traits>(basic_string_view<_Elem, _Traits>{_Added}));
+    }
+
     return *this;
 }
 
@@ -296,14 +578,22 @@ template _FILESYSTEM_API path& path::append(const wstring_view&);
 // FUNCTION path::operator==
 bool path::operator==(const path& _Compare) const noexcept {
     // avoid comparing with own value
-    return this != __builtin_addressof(_Compare) ? _Mytext == _Compare._Mytext : true;
+    if (this == __builtin_addressof(_Compare)) { // avoid comparing with own value
+        return true;
+    }
+
+    return hash() == _Compare.hash() && _Text() == _Compare._Text(); // different hashes means different paths
+}
+
+bool path::operator==(const path_view _Compare) const noexcept {
+    return _Text() == _Compare.view();
 }
 
 template <class _CharTy>
 bool path::operator==(const _CharTy* const _Compare) const {
     // _CharTy must be an chararcter (char/char8_t/char16_t/char32_t/wchar_t) type
     static_assert(_Is_char_t<_CharTy>, "invalid character type");
-    return _Mytext == _Convert_to_narrow<_CharTy, char_traits<_CharTy>>(_Compare);
+    return _Text() == _Convert_to_narrow<_CharTy, char_traits<_CharTy>>(_Compare);
 }
 
 template _FILESYSTEM_API bool path::operator==(const char* const) const;
@@ -316,7 +606,7 @@ template <class _Src>
 bool path::operator==(const _Src& _Compare) const {
     // _Src must be an string (basic_string/basic_string_view) type
     static_assert(_Is_src_t<_Src>, "invalid string type");
-    return _Mytext == _Convert_to_narrow<typename _Src::value_type, typename _Src::traits_type>(_Compare.data());
+    return _Text() == _Convert_to_narrow<typename _Src::value_type, typename _Src::traits_type>(_Compare.data());
 }
 
 template _FILESYSTEM_API bool path::operator==(const string&) const;
@@ -334,14 +624,22 @@ template _FILESYSTEM_API bool path::operator==(const wstring_view&) const;
 // FUNCTION path::operator!=
 bool path::operator!=(const path& _Compare) const noexcept {
     // avoid comparing with own value
-    return this != __builtin_addressof(_Compare) ? _Mytext != _Compare._Mytext : false;
+    if (this == __builtin_addressof(_Compare)) { // avoid comparing with own value
+        return false;
+    }
+
+    return hash() != _Compare.hash() || _Text() != _Compare._Text(); // different hashes means different paths
+}
+
+bool path::operator!=(const path_view _Compare) const noexcept {
+    return _Text() != _Compare.view();
 }
 
 template <class _CharTy>
 bool path::operator!=(const _CharTy* const _Compare) const {
     // _CharTy must be an chararcter (char/char8_t/char16_t/char32_t/wchar_t) type
     static_assert(_Is_char_t<_CharTy>, "invalid character type");
-    return _Mytext != _Convert_to_narrow<_CharTy, char_traits<_CharTy>>(_Compare);
+    return _Text() != _Convert_to_narrow<_CharTy, char_traits<_CharTy>>(_Compare);
 }
 
 template _FILESYSTEM_API bool path::operator!=(const char* const) const;
@@ -354,7 +652,7 @@ template <class _Src>
 bool path::operator!=(const _Src& _Compare) const {
     // _Src must be an string (basic_string/basic_string_view) type
     static_assert(_Is_src_t<_Src>, "invalid string type");
-    return _Mytext != _Convert_to_narrow<typename _Src::value_type, typename _Src::traits_type>(_Compare.data());
+    return _Text() != _Convert_to_narrow<typename _Src::value_type, typename _Src::traits_type>(_Compare.data());
 }
 
 template _FILESYSTEM_API bool path::operator!=(const string&) const;
@@ -370,239 +668,204 @@ template _FILESYSTEM_API bool path::operator!=(const u32string_view&) const;
 template _FILESYSTEM_API bool path::operator!=(const wstring_view&) const;
 
 // FUNCTION path::operator[]
-_NODISCARD constexpr path::reference path::operator[](const size_type _Pos) {
+_NODISCARD path::const_reference path::operator[](const size_type _Pos) const {
     return _Mytext[_Pos];
 }
 
-_NODISCARD constexpr path::const_reference path::operator[](const size_type _Pos) const {
+// FUNCTION path::at
+_NODISCARD path::const_reference path::at(const size_type _Pos) const {
+    if (_Pos >= _Mysize) {
+        _Throw_system_error("at", "invalid position", error_type::invalid_argument);
+    }
+
     return _Mytext[_Pos];
 }
 
-// FUNCTION path::at
-_NODISCARD constexpr path::reference path::at(const size_type _Pos) {
-    return _Mytext.at(_Pos);
+// FUNCTION path::begin
+_NODISCARD path::const_iterator path::begin() const noexcept {
+    return _Mytext;
 }
 
-_NODISCARD constexpr path::const_reference path::at(const size_type _Pos) const {
-    return _Mytext.at(_Pos);
+// FUNCTION path::c_str
+_NODISCARD const path::native_value_type* path::c_str() const noexcept {
+#if _HAS_WINDOWS
+    return _Mynative; // converted by _Reindex()
+#else // ^^^ _HAS_WINDOWS ^^^ / vvv !_HAS_WINDOWS vvv
+    return _Mytext; // already null-terminated
+#endif // _HAS_WINDOWS
 }
 
-// FUNCTION path::begin
-_NODISCARD constexpr path::iterator path::begin() noexcept {
-    return _Mytext.begin();
+// FUNCTION path::clear
+void path::clear() noexcept {
+    _Mysize    = 0;
+    _Mytext[0] = value_type(0);
+    _Myindex   = _Path_index{};
+    _Myhash    = _Hash_path(string_view{});
+#if _HAS_WINDOWS
+    _Mynative[0]   = L'\0';
+    _Mynative_size = 0;
+#endif // _HAS_WINDOWS
 }
 
-_NODISCARD constexpr path::const_iterator path::begin() const noexcept {
-    return _Mytext.begin();
+// FUNCTION path::components
+_NODISCARD path_component_range path::components() const noexcept {
+    return path_view{*this}.components();
 }
 
-// FUNCTION path::clear
-constexpr void path::clear() noexcept {
-    _Mytext.clear();
+// FUNCTION path::components_count
+_NODISCARD size_t path::components_count() const noexcept {
+    return _Index()._Count;
 }
 
 // FUNCTION path::directory
 _NODISCARD path path::directory() const noexcept {
-    if (has_directory()) {
-        const size_type _Pos{_Mytext.find_last_of(_Expected_slash)};
-        if (_Pos == npos) { // the path contain only one directory
-            return _Mytext;
-        }
-
-        if (_Pos == _Mytext.size() - 1) { // slash on the last position
-            return R"(\)";
-        }
-
-        return string_type(_Mytext, _Pos + 1, _Mytext.size() - 1);
-    }
-
-    return string_type();
+    return path_view{*this}.directory();
 }
 
 // FUNCTION path::drive
 _NODISCARD path path::drive() const noexcept {
-    // if has drive then first letter is drive
-    return has_drive() ? string_type(1, _Mytext[0]) : string_type();
+    return path_view{*this}.drive();
 }
 
 // FUNCTION path::empty
-_NODISCARD constexpr bool path::empty() const noexcept {
-    return _Mytext.empty();
+_NODISCARD bool path::empty() const noexcept {
+    return _Mysize == 0;
 }
 
 // FUNCTION path::end
-_NODISCARD constexpr path::iterator path::end() noexcept {
-    return _Mytext.end();
-}
-
-_NODISCARD constexpr path::const_iterator path::end() const noexcept {
-    return _Mytext.end();
+_NODISCARD path::const_iterator path::end() const noexcept {
+    return _Mytext + _Mysize;
 }
 
 // FUNCTION path::extension
 _NODISCARD path path::extension() const noexcept {
-    // if has extension, then everything after last dot is extension
-    return has_extension() ? string_type(_Mytext, _Mytext.find_last_of(".") + 1, _Mytext.size()) : string_type();
+    return path_view{*this}.extension();
 }
 
 // FUNCTION path::file
 _NODISCARD path path::file() const noexcept {
-    if (has_file()) { // if has file, then everything after last slash is filename
-        return _Mytext.find(_Expected_slash) != npos ?
-            string_type(_Mytext, _Mytext.find_last_of(_Expected_slash) + 1, _Mytext.size()) : string_type(_Mytext);
-    }
-
-    return string_type();
+    return path_view{*this}.file();
 }
 
 // FUNCTION path::fix
 _NODISCARD path& path::fix() noexcept {
-    string_type _Fixed;
-    for (size_type _Idx = 0; _Idx < _Mytext.size(); ++_Idx) { // leave only single slashs
-        if (_Fixed.size() > 0) {
-            if ((_Mytext[_Idx] == _Expected_slash || _Mytext[_Idx] == _Unexpected_slash)
-                && (_Fixed.back() == _Expected_slash || _Fixed.back() == _Unexpected_slash)) {
-                continue; // skip slash if is next in the row
+    // single pass: leave only single slashes and write them as expected slashes,
+    // the path is fixed in-place, it can only get shorter
+    size_type _Read{0};
+    size_type _Write{0};
+    bool _After_slash{false};
+    while (_Read < _Mysize) {
+#if _FILESYSTEM_SSE2
+        if (_Mysize - _Read >= 16) { // copy characters up to the next slash, 16 at a time
+            const __m128i _Chunk{_mm_loadu_si128(reinterpret_cast<const __m128i*>(_Mytext + _Read))};
+            const unsigned int _Slashes{static_cast<unsigned int>(_mm_movemask_epi8(_Has_unexpected_slash
+                ? _mm_or_si128(_mm_cmpeq_epi8(_Chunk, _mm_set1_epi8(_Expected_slash)),
+                    _mm_cmpeq_epi8(_Chunk, _mm_set1_epi8(_Unexpected_slash)))
+                : _mm_cmpeq_epi8(_Chunk, _mm_set1_epi8(_Expected_slash))))};
+            const size_type _Count{_Slashes == 0 ? 16 : static_cast<size_type>(_STD countr_zero(_Slashes))};
+            if (_Count > 0) {
+                if (_Write != _Read) { // something was removed before
+                    _CSTD memmove(_Mytext + _Write, _Mytext + _Read, _Count);
+                }
+
+                _Read       += _Count;
+                _Write      += _Count;
+                _After_slash = false;
+                continue;
             }
         }
+#endif // _FILESYSTEM_SSE2
 
-        _Fixed.push_back(_Mytext[_Idx]);
+        const value_type _Ch{_Mytext[_Read++]};
+        if (_Is_slash(_Ch)) {
+            if (!_After_slash) { // skip slash if is next in the row
+                _Mytext[_Write++] = _Expected_slash;
+                _After_slash      = true;
+            }
+        } else {
+            _Mytext[_Write++] = _Ch;
+            _After_slash      = false;
+        }
     }
 
-    _Mytext = _Fixed;
-    (void) make_preferred();
+    _Mysize          = _Write;
+    _Mytext[_Mysize] = value_type(0);
+    _Reindex();
     return *this;
 }
 
 // FUNCTION path::generic_string
 _NODISCARD const string path::generic_string() const noexcept {
-    return _Mytext;
+    return string{_Text()};
 }
 
 // FUNCTION path::generic_u8string
 _NODISCARD const u8string path::generic_u8string() const {
-    return _Convert_narrow_to_utf<char8_t, char_traits<char8_t>>(_Mytext.data());
+    return _Convert_narrow_to_utf<char8_t, char_traits<char8_t>>(_Text());
 }
 
 // FUNCTION path::generic_u16string
 _NODISCARD const u16string path::generic_u16string() const {
-    return _Convert_narrow_to_utf<char16_t, char_traits<char16_t>>(_Mytext.data());
+    return _Convert_narrow_to_utf<char16_t, char_traits<char16_t>>(_Text());
 }
 
 // FUNCTION path::generic_u32string
 _NODISCARD const u32string path::generic_u32string() const {
-    return _Convert_narrow_to_utf<char32_t, char_traits<char32_t>>(_Mytext.data());
+    return _Convert_narrow_to_utf<char32_t, char_traits<char32_t>>(_Text());
 }
 
 // FUNCTION path::generic_wstring
 _NODISCARD const wstring path::generic_wstring() const {
-    return _Convert_narrow_to_wide(code_page::utf8, _Mytext.data());
+#if _HAS_WINDOWS
+    return wstring{native()}; // already converted
+#else // ^^^ _HAS_WINDOWS ^^^ / vvv !_HAS_WINDOWS vvv
+    return _Convert_narrow_to_wide(code_page::utf8, _Text());
+#endif // _HAS_WINDOWS
 }
 
 // FUNCTION path::has_directory
 _NODISCARD bool path::has_directory() const noexcept {
-    if (empty() || has_file()) { // the directory must on the last position
-        return false;
-    } else { // if has the drive, then must be longer than 3 characters ("D:\")
-        return has_drive() ? _Mytext.size() > 3 : true;
-    }
+    return path_view{*this}.has_directory();
 }
 
 // FUNCTION path::has_drive
 _NODISCARD bool path::has_drive() const noexcept {
-    if (_Mytext.size() < 3) { // requires minimum 3 characters
-        return false;
-    }
-
-    if (_Mytext[1] != ':') { // second character must be ":"
-        return false;
-    }
-
-    // third character must be expected or unexpected slash
-    if (_Mytext[2] != _Expected_slash && _Mytext[2] != _Unexpected_slash) {
-        return false;
-    }
-
-    if (static_cast<int>(_Mytext[0]) >= 65 && static_cast<int>(_Mytext[0]) <= 90) { // only big letters
-        return true;
-    } else if (static_cast<int>(_Mytext[0]) >= 97 && static_cast<int>(_Mytext[0]) <= 122) { // only small letters
-        return true;
-    } else { // other characters
-        return false;
-    }
-
-    return false;
+    return path_view{*this}.has_drive();
 }
 
 // FUNCTION path::has_extension
 _NODISCARD bool path::has_extension() const noexcept {
-    if (_Mytext.find(".") != npos) {
-        const size_type _Dot_pos{_Mytext.find_last_of(".")};
-
-        // example of this case:
-        // "Disk:\Directory\Subdirectory."
-        if (_Dot_pos < _Mytext.size()) {
-            if (const size_type _Last = _Mytext.find_last_of(_Expected_slash);
-                _Last < _Mytext.size() && _Last > _Dot_pos) { // for example: "Disk:\File.Extension\"
-                return false;
-            }
-
-            // for example: "Disk:\File."
-            return _Dot_pos != _Mytext.size() - 1;
-        } else {
-            return false;
-        }
-    }
-
-    return false;
+    return path_view{*this}.has_extension();
 }
 
 // FUNCTION path::has_file
 _NODISCARD bool path::has_file() const noexcept {
-    // file cannot exists without extension
-    return has_extension();
+    return path_view{*this}.has_file();
 }
 
 // FUNCTION path::has_parent_directory
 _NODISCARD bool path::has_parent_directory() const noexcept {
-    // if has root directory, then must be longer than root path, otherwise all path is parent path
-    return has_root_directory() ? _Mytext.size() > root_path()._Mytext.size() : true;
+    return path_view{*this}.has_parent_directory();
 }
 
 // FUNCTION path::has_root_directory
 _NODISCARD bool path::has_root_directory() const noexcept {
-    // slash on first place where there's no drive means, that it's root directory
-    if (!has_drive() && (_Mytext[0] == _Expected_slash || _Mytext[0] == _Unexpected_slash)) {
-        return true;
-    }
-
-    // directory after drive is root directory
-    if (has_drive() && _Mytext.size() > 3) {
-        return true;
-    }
-
-    return false;
+    return path_view{*this}.has_root_directory();
 }
 
 // FUNCTION path::has_stem
 _NODISCARD bool path::has_stem() const noexcept {
-    // stem is just filename without extension
-    return has_file();
+    return path_view{*this}.has_stem();
+}
+
+// FUNCTION path::hash
+_NODISCARD size_t path::hash() const noexcept {
+    return _Myhash;
 }
 
 // FUNCTION path::is_absolute
 _NODISCARD bool path::is_absolute() const noexcept {
-    if (_Mytext.find(_Expected_slash) == npos
-        && _Mytext.find(_Unexpected_slash) == npos) { // path without any slash
-        return false;
-    }
-
-    // path with drive and/or root directory must be absolute
-    if (has_drive() || has_root_directory()) {
-        return true;
-    }
-
-    return false;
+    return path_view{*this}.is_absolute();
 }
 
 // FUNCTION path::is_relative
@@ -612,56 +875,115 @@ _NODISCARD bool path::is_relative() const noexcept {
 
 // FUNCTION path::make_preferred
 _NODISCARD path& path::make_preferred() noexcept {
-    if (!empty()) {
-        for (auto& _Ch : _Mytext) {
-            if (_Ch == _Unexpected_slash) {
-                _Ch = _Expected_slash;
+    if (!_Has_unexpected_slash) { // '\\' is a legal character of names on Linux, nothing to replace
+        return *this;
+    }
+
+    size_type _Idx{0};
+#if _FILESYSTEM_SSE2
+    const __m128i _Expected{_mm_set1_epi8(_Expected_slash)};
+    const __m128i _Unexpected{_mm_set1_epi8(_Unexpected_slash)};
+    for (; _Mysize - _Idx >= 16; _Idx += 16) { // replace 16 characters at a time
+        __m128i* const _Ptr{reinterpret_cast<__m128i*>(_Mytext + _Idx)};
+        const __m128i _Chunk{_mm_loadu_si128(_Ptr)};
+        const __m128i _Found{_mm_cmpeq_epi8(_Chunk, _Unexpected)};
+        if (_mm_movemask_epi8(_Found) != 0) { // store only if something has changed
+            _mm_storeu_si128(_Ptr, _mm_or_si128(_mm_andnot_si128(_Found, _Chunk), _mm_and_si128(_Found, _Expected)));
+        }
+    }
+#endif // _FILESYSTEM_SSE2
+
+    for (; _Idx < _Mysize; ++_Idx) {
+        if (_Mytext[_Idx] == _Unexpected_slash) {
+            _Mytext[_Idx] = _Expected_slash;
+        }
+    }
+
+    _Reindex();
+    return *this;
+}
+
+// FUNCTION path::native
+_NODISCARD path::native_string_view path::native() const noexcept {
+#if _HAS_WINDOWS
+    const native_value_type* const _Native{c_str()};
+    return native_string_view{_Native, _Mynative_size};
+#else // ^^^ _HAS_WINDOWS ^^^ / vvv !_HAS_WINDOWS vvv
+    return _Text();
+#endif // _HAS_WINDOWS
+}
+
+// FUNCTION path::normalize
+_NODISCARD path& path::normalize() noexcept {
+    (void) fix(); // from now only single expected slashes
+    const size_type _Root{_Myindex._Root_size}; // "D:\" or "\" is never removed
+    const bool _Relative{_Root == 0};
+    size_type _Read{_Root};
+    size_type _Write{_Root}; // normalized in-place, it can only get shorter
+    size_type _Removable{0}; // number of kept components that can be removed by ".."
+    while (_Read < _Mysize) {
+        const size_type _Slash{_Text().find(_Expected_slash, _Read)};
+        const size_type _End{_Slash == npos ? _Mysize : _Slash};
+        const string_view _Component{_Mytext + _Read, _End - _Read};
+        _Read = _End + 1;
+        if (_Component.empty() || _Component == ".") { // nothing to keep
+            continue;
+        }
+
+        if (_Component == "..") {
+            if (_Removable > 0) { // remove the last kept component together with its slash
+                const size_type _Last{string_view{_Mytext + _Root, _Write - _Root}.find_last_of(_Expected_slash)};
+                _Write = _Last == npos ? _Root : _Root + _Last;
+                --_Removable;
+                continue;
+            } else if (!_Relative) { // ".." of the root is the root
+                continue;
             }
+        } else {
+            ++_Removable;
+        }
+
+        if (_Write > _Root) { // separate from the previous component
+            _Mytext[_Write++] = _Expected_slash;
         }
+
+        _CSTD memmove(_Mytext + _Write, _Component.data(), _Component.size());
+        _Write += _Component.size();
     }
-    
+
+    if (_Write == 0 && _Mysize > 0) { // for example: "Directory\.."
+        _Mytext[_Write++] = '.';
+    }
+
+    _Mysize          = _Write;
+    _Mytext[_Mysize] = value_type(0);
+    _Reindex();
     return *this;
 }
 
 // FUNCTION path::parent_directory
 _NODISCARD path path::parent_directory() const noexcept {
-    // if has parent directory, then return only first directory from parent path
-    return has_parent_directory() ? string_type(parent_path()._Mytext, 0,
-        parent_path()._Mytext.find_first_of(_Expected_slash)) : string_type();
+    return path_view{*this}.parent_directory();
 }
 
 // FUNCTION path::rend
-_NODISCARD constexpr path::reverse_iterator path::rend() noexcept {
-    return _Mytext.rend();
-}
-
-_NODISCARD constexpr path::const_reverse_iterator path::rend() const noexcept {
-    return _Mytext.rend();
+_NODISCARD path::const_reverse_iterator path::rend() const noexcept {
+    return const_reverse_iterator{begin()};
 }
 
 // FUNCTION path::parent_path
 _NODISCARD path path::parent_path() const noexcept {
-    if (has_parent_directory()) { // parent path is everything after root directory
-        if (has_drive()) { // remove drive and root directory (with ":" and 2 slashes)
-            return string_type(_Mytext, drive()._Mytext.size()
-                + root_directory()._Mytext.size() + 3, _Mytext.size());
-        } else if (!has_drive() && has_root_directory()) { // remove only root directory (with 2 slashes)
-            return string_type(_Mytext, root_directory()._Mytext.size() + 2, _Mytext.size());
-        } else { // nothing to do, because current working path is parent path
-            return _Mytext;
-        }
-    }
-
-    return string_type();
+    return path_view{*this}.parent_path();
 }
 
 // FUNCTION path::remove_directory
 _NODISCARD path& path::remove_directory(const bool _With_slash) noexcept {
     if (has_directory()) {
-        if (_Mytext.find(_Expected_slash) == npos) {
-            _Mytext.clear();
+        const size_type _Last_slash{_Index()._Last_slash};
+        if (_Last_slash == npos) {
+            clear();
         } else {
-            _Mytext.resize(_Mytext.find_last_of(_Expected_slash) + (_With_slash ? 0 : 1));
+            resize(_Last_slash + (_With_slash ? 0 : 1));
         }
     }
 
@@ -671,7 +993,7 @@ _NODISCARD path& path::remove_directory(const bool _With_slash) noexcept {
 // FUNCTION path::remove_extension
 _NODISCARD path& path::remove_extension() noexcept {
     if (has_extension()) {
-        _Mytext.resize(_Mytext.find_last_of("."));
+        resize(_Index()._Last_dot);
     }
 
     return *this;
@@ -681,9 +1003,8 @@ _NODISCARD path& path::remove_extension() noexcept {
 _NODISCARD path& path::remove_file(const bool _With_slash) noexcept {
     if (has_file()) {
         // if path contains only filename, then clear it
-        _Mytext.find(_Expected_slash) != npos?
-            _Mytext.resize(_With_slash ? _Mytext.find_last_of(_Expected_slash)
-                : _Mytext.find_last_of(_Expected_slash) + 1) : clear();
+        const size_type _Last_slash{_Index()._Last_slash};
+        _Last_slash != npos ? resize(_With_slash ? _Last_slash : _Last_slash + 1) : clear();
     }
 
     return *this;
@@ -693,8 +1014,7 @@ _NODISCARD path& path::remove_file(const bool _With_slash) noexcept {
 _NODISCARD path& path::replace_directory(const path& _Replacement) {
     if (has_directory()) {
         (void) remove_directory(false);
-        _Mytext += _Replacement._Mytext;
-        _Check_size();
+        _Append(_Replacement._Text());
     }
 
     return *this;
@@ -704,9 +1024,11 @@ _NODISCARD path& path::replace_directory(const path& _Replacement) {
 _NODISCARD path& path::replace_extension(const path& _Replacement) {
     if (has_extension()) {
         (void) remove_extension();
-        _Mytext += _Replacement._Mytext[0] == '.' ?
-            _Replacement._Mytext : "." + _Replacement._Mytext;
-        _Check_size();
+        if (_Replacement._Mytext[0] != '.') {
+            _Append(".");
+        }
+
+        _Append(_Replacement._Text());
     }
 
     return *this;
@@ -715,10 +1037,8 @@ _NODISCARD path& path::replace_extension(const path& _Replacement) {
 // FUNCTION path::replace_file
 _NODISCARD path& path::replace_file(const path& _Replacement) {
     if (has_file()) {
-        (void) remove_file(_Replacement._Mytext[0] == _Expected_slash
-            || _Replacement._Mytext[0] == _Unexpected_slash);
-        _Mytext += _Replacement._Mytext;
-        _Check_size();
+        (void) remove_file(_Is_slash(_Replacement._Mytext[0]));
+        _Append(_Replacement._Text());
     }
 
     return *this;
@@ -727,98 +1047,567 @@ _NODISCARD path& path::replace_file(const path& _Replacement) {
 // FUNCTION path::replace_stem
 _NODISCARD path& path::replace_stem(const path& _Replacement) {
     if (has_stem()) {
-        const auto& _Ext{extension()};
+        const path _Ext{extension()};
         (void) remove_file(false);
-        _Mytext += _Replacement._Mytext;
-        _Mytext += "." + _Ext._Mytext;
-        _Check_size();
+        _Append(_Replacement._Text());
+        _Append(".");
+        _Append(_Ext._Text());
     }
 
     return *this;
 }
 
 // FUNCTION path::resize
-constexpr void path::resize(const size_type _Newsize, const value_type _Ch) {
-    _Mytext.resize(_Newsize, _Ch);
-    _Check_size();
+void path::resize(const size_type _Newsize, const value_type _Ch) {
+    _Check_size(_Newsize);
+    if (_Newsize > _Mysize) { // fill new characters with _Ch
+        _CSTD memset(_Mytext + _Mysize, _Ch, _Newsize - _Mysize);
+    }
+
+    _Mysize          = _Newsize;
+    _Mytext[_Mysize] = value_type(0);
+    _Reindex();
 }
 
 // FUNCTION path::root_directory
 _NODISCARD path path::root_directory() const noexcept {
-    // if has root directory, then return only first directory from root path
-    return has_root_directory() ? string_type(root_path()._Mytext, 0,
-        root_path()._Mytext.find_first_of(_Expected_slash)) : string_type();
+    return path_view{*this}.root_directory();
 }
 
 // FUNCTION path::root_path
 _NODISCARD path path::root_path() const noexcept {
-    // if has root directory, then return everything after first slash
-    return has_root_directory() ? string_type(_Mytext, _Mytext.find_first_of(_Expected_slash), _Mytext.size()) : string_type();
+    return path_view{*this}.root_path();
 }
 
 // FUNCTION path::size
-_NODISCARD constexpr size_t path::size() const noexcept {
-    return _Mytext.size();
+_NODISCARD size_t path::size() const noexcept {
+    return _Mysize;
 }
 
 // FUNCTION path::stem
 _NODISCARD path path::stem() const noexcept {
+    return path_view{*this}.stem();
+}
+
+// FUNCTION path_view::path_view
+path_view::path_view() noexcept : _Mydata(""), _Mysize(0), _Myindex(), _Myhash(0) {}
+
+path_view::path_view(const path& _Source) noexcept
+    : _Mydata(_Source._Mytext), _Mysize(_Source._Mysize), _Myindex(_Source._Index()), _Myhash(_Source.hash()) {}
+
+path_view::path_view(const char* const _Source) noexcept : path_view(string_view{_Source}) {}
+
+path_view::path_view(const string& _Source) noexcept : path_view(string_view{_Source}) {}
+
+path_view::path_view(const string_view _Source) noexcept
+    : _Mydata(_Source.data()), _Mysize(_Source.size()), _Myindex(_Make_path_index(_Source)), _Myhash(0) {}
+
+// FUNCTION path_view::operator==
+bool path_view::operator==(const path_view _Compare) const noexcept {
+    if (_Myhash != 0 && _Compare._Myhash != 0 && _Myhash != _Compare._Myhash) { // both views refer to paths
+        return false;
+    }
+
+    return view() == _Compare.view();
+}
+
+// FUNCTION path_view::operator!=
+bool path_view::operator!=(const path_view _Compare) const noexcept {
+    return !(*this == _Compare);
+}
+
+// FUNCTION path_view::operator[]
+_NODISCARD path_view::const_reference path_view::operator[](const size_type _Pos) const noexcept {
+    return _Mydata[_Pos];
+}
+
+// FUNCTION path_view::at
+_NODISCARD path_view::const_reference path_view::at(const size_type _Pos) const {
+    if (_Pos >= _Mysize) {
+        _Throw_system_error("at", "invalid position", error_type::invalid_argument);
+    }
+
+    return _Mydata[_Pos];
+}
+
+// FUNCTION path_view::begin
+_NODISCARD path_view::const_iterator path_view::begin() const noexcept {
+    return _Mydata;
+}
+
+// FUNCTION path_view::components
+_NODISCARD path_component_range path_view::components() const noexcept {
+    const char* const _Last{_Mydata + _Mysize};
+    return path_component_range{
+        path_component_iterator{_Mydata, _Last, _Mydata}, path_component_iterator{_Mydata, _Last, _Last}};
+}
+
+// FUNCTION path_view::components_count
+_NODISCARD size_t path_view::components_count() const noexcept {
+    return _Myindex._Count;
+}
+
+// FUNCTION path_view::data
+_NODISCARD path_view::const_pointer path_view::data() const noexcept {
+    return _Mydata;
+}
+
+// FUNCTION path_view::directory
+_NODISCARD path_view path_view::directory() const noexcept {
+    if (has_directory()) {
+        const size_type _Pos{_Myindex._Last_slash};
+        if (_Pos == npos) { // the path contain only one directory
+            return *this;
+        }
+
+        if (_Pos == _Mysize - 1) { // slash on the last position
+            return _Expected_slash_string;
+        }
+
+        return view().substr(_Pos + 1, _Mysize - 1);
+    }
+
+    return path_view();
+}
+
+// FUNCTION path_view::drive
+_NODISCARD path_view path_view::drive() const noexcept {
+    // if has drive then first letter is drive
+    return has_drive() ? view().substr(0, 1) : path_view();
+}
+
+// FUNCTION path_view::empty
+_NODISCARD bool path_view::empty() const noexcept {
+    return _Mysize == 0;
+}
+
+// FUNCTION path_view::end
+_NODISCARD path_view::const_iterator path_view::end() const noexcept {
+    return _Mydata + _Mysize;
+}
+
+// FUNCTION path_view::extension
+_NODISCARD path_view path_view::extension() const noexcept {
+    // if has extension, then everything after last dot is extension
+    return has_extension() ? view().substr(_Myindex._Last_dot + 1) : path_view();
+}
+
+// FUNCTION path_view::file
+_NODISCARD path_view path_view::file() const noexcept {
+    if (has_file()) { // if has file, then everything after last slash is filename
+        return _Myindex._Last_slash != npos ? view().substr(_Myindex._Last_slash + 1) : *this;
+    }
+
+    return path_view();
+}
+
+// FUNCTION path_view::generic_string
+_NODISCARD const string path_view::generic_string() const {
+    return string{view()};
+}
+
+// FUNCTION path_view::has_directory
+_NODISCARD bool path_view::has_directory() const noexcept {
+    if (empty() || has_file()) { // the directory must on the last position
+        return false;
+    } else { // if has the drive, then must be longer than 3 characters ("D:\")
+        return has_drive() ? _Mysize > 3 : true;
+    }
+}
+
+// FUNCTION path_view::has_drive
+_NODISCARD bool path_view::has_drive() const noexcept {
+    // drive letter, ":" and slash (for example: "D:\")
+    return _Myindex._Root_size == 3;
+}
+
+// FUNCTION path_view::has_extension
+_NODISCARD bool path_view::has_extension() const noexcept {
+    if (_Myindex._Last_dot == npos) {
+        return false;
+    }
+
+    if (_Myindex._Last_slash != npos && _Myindex._Last_slash > _Myindex._Last_dot) { // for example: "Disk:\File.Extension\"
+        return false;
+    }
+
+    // for example: "Disk:\File."
+    return _Myindex._Last_dot != _Mysize - 1;
+}
+
+_NODISCARD bool path_view::has_extension(const path_view _Ext) const noexcept {
+    return has_extension() && extension() == _Ext;
+}
+
+// FUNCTION path_view::has_file
+_NODISCARD bool path_view::has_file() const noexcept {
+    // file cannot exists without extension
+    return has_extension();
+}
+
+// FUNCTION path_view::has_parent_directory
+_NODISCARD bool path_view::has_parent_directory() const noexcept {
+    // if has root directory, then must be longer than root path, otherwise all path is parent path
+    return has_root_directory() ? _Myindex._First_slash > 0 : true; // root path starts at the first slash
+}
+
+// FUNCTION path_view::has_root_directory
+_NODISCARD bool path_view::has_root_directory() const noexcept {
+    // slash on first place where there's no drive means, that it's root directory
+    if (_Myindex._Root_size == 1) {
+        return true;
+    }
+
+    // directory after drive is root directory
+    if (has_drive() && _Mysize > 3) {
+        return true;
+    }
+
+    return false;
+}
+
+// FUNCTION path_view::has_stem
+_NODISCARD bool path_view::has_stem() const noexcept {
+    // stem is just filename without extension
+    return has_file();
+}
+
+// FUNCTION path_view::hash
+_NODISCARD size_t path_view::hash() const noexcept {
+    return _Myhash != 0 ? _Myhash : _Hash_path(view());
+}
+
+// FUNCTION path_view::is_absolute
+_NODISCARD bool path_view::is_absolute() const noexcept {
+    if (_Myindex._First_slash == npos && !_Myindex._Unexpected) { // path without any slash
+        return false;
+    }
+
+    // path with drive and/or root directory must be absolute
+    if (has_drive() || has_root_directory()) {
+        return true;
+    }
+
+    return false;
+}
+
+// FUNCTION path_view::is_relative
+_NODISCARD bool path_view::is_relative() const noexcept {
+    return !is_absolute();
+}
+
+// FUNCTION path_view::parent_directory
+_NODISCARD path_view path_view::parent_directory() const noexcept {
+    // if has parent directory, then return only first directory from parent path
+    if (has_parent_directory()) {
+        const path_view _Parent{parent_path()};
+        return _Parent.view().substr(0, _Parent._Myindex._First_slash);
+    }
+
+    return path_view();
+}
+
+// FUNCTION path_view::parent_path
+_NODISCARD path_view path_view::parent_path() const noexcept {
+    if (has_parent_directory()) { // parent path is everything after root directory
+        if (has_drive()) { // remove drive and root directory (with ":" and 2 slashes)
+            return view().substr(drive()._Mysize + root_directory()._Mysize + 3);
+        } else if (!has_drive() && has_root_directory()) { // remove only root directory (with 2 slashes)
+            return view().substr(root_directory()._Mysize + 2);
+        } else { // nothing to do, because current working path is parent path
+            return *this;
+        }
+    }
+
+    return path_view();
+}
+
+// FUNCTION path_view::rend
+_NODISCARD path_view::const_reverse_iterator path_view::rend() const noexcept {
+    return const_reverse_iterator{begin()};
+}
+
+// FUNCTION path_view::root_directory
+_NODISCARD path_view path_view::root_directory() const noexcept {
+    // if has root directory, then return only first directory from root path
+    if (has_root_directory()) {
+        const path_view _Root{root_path()};
+        return _Root.view().substr(0, _Root._Myindex._First_slash);
+    }
+
+    return path_view();
+}
+
+// FUNCTION path_view::root_path
+_NODISCARD path_view path_view::root_path() const noexcept {
+    // if has root directory, then return everything after first slash
+    return has_root_directory() ? view().substr(_Myindex._First_slash) : path_view();
+}
+
+// FUNCTION path_view::size
+_NODISCARD size_t path_view::size() const noexcept {
+    return _Mysize;
+}
+
+// FUNCTION path_view::stem
+_NODISCARD path_view path_view::stem() const noexcept {
     if (has_stem()) {
-        auto _Stem{_Mytext}; // don't change original text
-        if (_Stem.find_last_of(_Expected_slash) != npos) {
-            _Stem.replace(0, _Stem.find_last_of(_Expected_slash) + 1, string_type()); // leave only filename with extension
-            _Stem.resize(_Stem.find_last_of(".")); // remove extension
-            return _Stem; // break here
+        if (_Myindex._Last_slash != npos) { // leave only filename without extension
+            return view().substr(_Myindex._Last_slash + 1, _Myindex._Last_dot - _Myindex._Last_slash - 1);
         }
         
         // path contains only filename
-        _Stem.resize(_Stem.find_first_of(".")); // remove extension
-        return _Stem;
+        return view().substr(0, _Myindex._First_dot); // remove extension
     }
     
-    return string_type();
+    return path_view();
+}
+
+// FUNCTION path_view::view
+_NODISCARD string_view path_view::view() const noexcept {
+    return string_view{_Mydata, _Mysize};
+}
+
+// FUNCTION path_hash::operator()
+_NODISCARD size_t path_hash::operator()(const path_view _Path) const noexcept {
+    return _Path.hash();
+}
+
+// FUNCTION path_equal::operator()
+_NODISCARD bool path_equal::operator()(const path_view _Left, const path_view _Right) const noexcept {
+    return _Left == _Right;
+}
+
+// FUNCTION path_builder::path_builder
+path_builder::path_builder() noexcept : _Mypath(), _Mymarks(), _Mydepth(0) {}
+
+path_builder::path_builder(const path_view _Base) : _Mypath(_Base), _Mymarks(), _Mydepth(0) {}
+
+// FUNCTION path_builder::depth
+_NODISCARD size_t path_builder::depth() const noexcept {
+    return _Mydepth;
+}
+
+// FUNCTION path_builder::get
+_NODISCARD const path& path_builder::get() const noexcept {
+    return _Mypath;
+}
+
+// FUNCTION path_builder::pop
+void path_builder::pop() noexcept {
+    if (_Mydepth > 0) { // restore the saved state, the text before the mark hasn't been changed since push()
+        const _Push_mark& _Mark{_Mymarks[--_Mydepth]};
+        _Mypath._Mysize                  = _Mark._Size;
+        _Mypath._Mytext[_Mypath._Mysize] = path::value_type(0);
+        _Mypath._Myindex                 = _Mark._Index;
+        _Mypath._Myhash                  = _Mark._Hash;
+#if _HAS_WINDOWS
+        _Mypath._Mynative_size                    = _Mark._Native_size;
+        _Mypath._Mynative[_Mypath._Mynative_size] = L'\0';
+#endif // _HAS_WINDOWS
+    }
+}
+
+// FUNCTION path_builder::push
+path_builder& path_builder::push(const path_view _Component) {
+    if (_Mydepth == _Max_depth) {
+        _Throw_system_error("push", "too many components", error_type::length_error);
+    }
+
+    const size_t _Old_size{_Mypath._Mysize};
+    const string_view _Text{_Mypath._Text()};
+    const bool _Needs_slash{!_Text.empty() && _Text.back() != _Expected_slash}; // avoid doubled slash after the root
+    path::_Check_size(_Old_size + (_Needs_slash ? 1 : 0) + _Component.size()); // verify before any change
+    _Push_mark& _Mark{_Mymarks[_Mydepth++]};
+    _Mark._Size  = _Old_size;
+    _Mark._Index = _Mypath._Myindex;
+    _Mark._Hash  = _Mypath._Myhash;
+#if _HAS_WINDOWS
+    _Mark._Native_size = _Mypath._Mynative_size;
+#endif // _HAS_WINDOWS
+
+    // write both pieces, then index only them, the old text ends with a slash or the new one starts with it
+    size_t _New_size{_Old_size};
+    if (_Needs_slash) {
+        _Mypath._Mytext[_New_size++] = _Expected_slash;
+    }
+
+    _CSTD memmove(_Mypath._Mytext + _New_size, _Component.data(), _Component.size()); // may be a part of the path
+    _New_size                       += _Component.size();
+    _Mypath._Mysize                  = _New_size;
+    _Mypath._Mytext[_Mypath._Mysize] = path::value_type(0);
+    _Mypath._Extend(_Old_size);
+    return *this;
+}
+
+// FUNCTION path_builder::reset
+void path_builder::reset(const path_view _Base) {
+    _Mypath._Assign(_Base.view());
+    _Mydepth = 0;
+}
+
+// FUNCTION _Same_root
+_NODISCARD bool _Same_root(const path_view _Left, const path_view _Right) noexcept {
+    const size_t _Size{_Root_size(_Left.view())};
+    if (_Size != _Root_size(_Right.view())) {
+        return false;
+    }
+
+    // drive letters must match, slashes may differ
+    return _Size != 3 || _Left.view().substr(0, 2) == _Right.view().substr(0, 2);
+}
+
+// FUNCTION common_prefix
+_NODISCARD path_view common_prefix(const path_view _Left, const path_view _Right) noexcept {
+    if (!_Same_root(_Left, _Right)) {
+        return path_view();
+    }
+
+    const path_component_range _Left_range{_Left.components()};
+    const path_component_range _Right_range{_Right.components()};
+    auto _Left_it{_Left_range.begin()};
+    auto _Right_it{_Right_range.begin()};
+    size_t _Size{_Root_size(_Left.view())}; // the root is always shared
+    for (; _Left_it != _Left_range.end() && _Right_it != _Right_range.end(); ++_Left_it, ++_Right_it) {
+        const string_view _Component{_Left_it.component()};
+        if (_Component != _Right_it.component()) {
+            break;
+        }
+
+        _Size = (_STD max)(_Size, static_cast<size_t>(_Component.data() - _Left.data()) + _Component.size());
+    }
+
+    return _Left.view().substr(0, _Size);
 }
 
 // FUNCTION current_path
 _NODISCARD path current_path() noexcept {
+#if _HAS_WINDOWS
     wchar_t _Buff[_Max_path];
     _FILESYSTEM_VERIFY(GetCurrentDirectoryW(_Max_path, _Buff) > 0, "failed to get current path", error_type::runtime_error);
     return path(static_cast<const wchar_t*>(_Buff));
+#else // ^^^ _HAS_WINDOWS ^^^ / vvv !_HAS_WINDOWS vvv
+    char _Buff[_Max_path + 1];
+    _FILESYSTEM_VERIFY(::getcwd(_Buff, sizeof(_Buff)) != nullptr, "failed to get current path", error_type::runtime_error);
+    return path(static_cast<const char*>(_Buff));
+#endif // _HAS_WINDOWS
 }
 
 _NODISCARD bool current_path(const path& _Path) { // sets new current path
     _FILESYSTEM_VERIFY(exists(_Path) && _Is_directory(_Path), "invalid path", error_type::runtime_error);
-    _FILESYSTEM_VERIFY(SetCurrentDirectoryW(_Path.generic_wstring().c_str()),
+#if _HAS_WINDOWS
+    _FILESYSTEM_VERIFY(SetCurrentDirectoryW(_Path.c_str()),
         "failed to set new path", error_type::runtime_error);
+#else // ^^^ _HAS_WINDOWS ^^^ / vvv !_HAS_WINDOWS vvv
+    _FILESYSTEM_VERIFY(::chdir(_Path.c_str()) == 0, "failed to set new path", error_type::runtime_error);
+#endif // _HAS_WINDOWS
     return true;
 }
 
+// FUNCTION lexically_relative
+_NODISCARD path lexically_relative(const path_view _Path, const path_view _Base) {
+    if (!_Same_root(_Path, _Base)) {
+        return path();
+    }
+
+    const path_component_range _Path_range{_Path.components()};
+    const path_component_range _Base_range{_Base.components()};
+    auto _Path_it{_Path_range.begin()};
+    auto _Base_it{_Base_range.begin()};
+    while (_Path_it != _Path_range.end() && _Base_it != _Base_range.end()
+           && _Path_it.component() == _Base_it.component()) { // skip the common prefix
+        ++_Path_it;
+        ++_Base_it;
+    }
+
+    ptrdiff_t _Ups{0}; // number of ".." needed to leave the rest of _Base
+    for (; _Base_it != _Base_range.end(); ++_Base_it) {
+        const string_view _Component{_Base_it.component()};
+        if (_Component == "..") {
+            --_Ups;
+        } else if (_Component != ".") {
+            ++_Ups;
+        }
+    }
+
+    if (_Ups < 0) { // _Base leaves the common prefix, the result is unknown
+        return path();
+    }
+
+    if (_Ups == 0 && _Path_it == _Path_range.end()) { // both paths point to the same place
+        return path(".");
+    }
+
+    path_builder _Builder;
+    for (; _Ups > 0; --_Ups) {
+        _Builder.push("..");
+    }
+
+    for (; _Path_it != _Path_range.end(); ++_Path_it) {
+        _Builder.push(_Path_it.component());
+    }
+
+    return _Builder.get();
+}
+
 // FUNCTION make_path
 _NODISCARD path make_path(const path& _Path, const bool _Module) {
     if (_Module) { // build path with current executable directory
+#if _HAS_WINDOWS
         wchar_t _Buff[_Max_path];
-        _FILESYSTEM_VERIFY(GetModuleFileNameW(nullptr, _Buff, _Max_path) > 0,
-            "failed to get current executable path", error_type::runtime_error);
+        const unsigned long _Size{GetModuleFileNameW(nullptr, _Buff, _Max_path)};
+        _FILESYSTEM_VERIFY(_Size > 0, "failed to get current executable path", error_type::runtime_error);
+        if (_Size == _Max_path) { // GetModuleFileNameW() truncates silently, the path is too long
+            _Throw_system_error("make_path", "invalid length", error_type::length_error);
+        }
+
         path _Result = static_cast<const wchar_t*>(_Buff);
         (void) _Result.remove_file(); // leave only directories
-        _Result += _Path[0] == '\\' ? _Path : R"(\)" + _Path;
+#else // ^^^ _HAS_WINDOWS ^^^ / vvv !_HAS_WINDOWS vvv
+        char _Buff[_Max_path + 1];
+        const ssize_t _Size{::readlink("/proc/self/exe", _Buff, sizeof(_Buff))};
+        _FILESYSTEM_VERIFY(_Size > 0, "failed to get current executable path", error_type::runtime_error);
+        if (static_cast<size_t>(_Size) == sizeof(_Buff)) { // readlink() truncates silently, the path is too long
+            _Throw_system_error("make_path", "invalid length", error_type::length_error);
+        }
+
+        _Buff[_Size] = '\0'; // readlink() doesn't append null-terminator
+        *_CSTD strrchr(_Buff, _Expected_slash) = '\0'; // leave only directories (remove_file() needs an extension)
+        path _Result = static_cast<const char*>(_Buff);
+#endif // _HAS_WINDOWS
+        _Result += _Path[0] == _Expected_slash ? _Path : _Expected_slash_string + _Path;
         return _Result;
     } else { // build path with current directory
-        return path(current_path() + (_Path[0] == '\\' ?
-            _Path : R"(\)" + _Path));
+        return path(current_path() + (_Path[0] == _Expected_slash ?
+            _Path : _Expected_slash_string + _Path));
     }
 }
 
 // FUNCTION temp_directory_path
 _NODISCARD path temp_directory_path() {
+#if _HAS_WINDOWS
     wchar_t _Buff[_Max_path];
     const unsigned long _Size{GetTempPathW(_Max_path, _Buff)};
     _FILESYSTEM_VERIFY(_Size > 0, "failed to get temporary path", error_type::runtime_error);
     path _Tmp{static_cast<const wchar_t*>(_Buff)};
-    if (_Tmp.generic_string().back() == _Expected_slash) { // unnecessary slash on last position
+#else // ^^^ _HAS_WINDOWS ^^^ / vvv !_HAS_WINDOWS vvv
+    // the same variables that POSIX systems check, "/tmp" if none of them is set
+    const char* _Env{nullptr};
+    for (const char* const _Name : {"TMPDIR", "TMP", "TEMP", "TEMPDIR"}) {
+        _Env = ::getenv(_Name);
+        if (_Env && *_Env != '\0') {
+            break;
+        }
+
+        _Env = nullptr;
+    }
+
+    path _Tmp{_Env ? _Env : "/tmp"};
+#endif // _HAS_WINDOWS
+    if (_Tmp.size() > 1 && _Tmp.generic_string().back() == _Expected_slash) { // unnecessary slash on last position
         _Tmp.resize(_Tmp.size() - 1);
         if (!exists(_Tmp)) { // sometimes slash on last position can be important, we should check it
-            _Tmp += R"(\)";
+            _Tmp += _Expected_slash_string;
             _FILESYSTEM_VERIFY(exists(_Tmp), "temporary directory path not found", error_type::runtime_error);
 
             // if won't throw an exception, return will contain slash on last position
@@ -828,32 +1617,4 @@ _NODISCARD path temp_directory_path() {
     _FILESYSTEM_VERIFY(_Is_directory(_Tmp), "temporary directory path not found", error_type::runtime_error);
     return _Tmp;
 }
-
-#pragma warning(push)
-#pragma warning(disable : 4455) // C4455: reserved name
-namespace path_literals {
-    // FUNCTION operator""p
-    _NODISCARD path operator""p(const char* const _Str, const size_t _Size) noexcept {
-        return path(_Str);
-    }
-
-    _NODISCARD path operator""p(const char8_t* const _Str, const size_t _Size) noexcept {
-        return path(_Str);
-    }
-
-    _NODISCARD path operator""p(const char16_t* const _Str, const size_t _Size) noexcept {
-        return path(_Str);
-    }
-
-    _NODISCARD path operator""p(const char32_t* const _Str, const size_t _Size) noexcept {
-        return path(_Str);
-    }
-
-    _NODISCARD path operator""p(const wchar_t* const _Str, const size_t _Size) noexcept {
-        return path(_Str);
-    }
-} // path_literals
-#pragma warning(pop)
-_FILESYSTEM_END
-
-#endif // !_HAS_WINDOWS
\ No newline at end of file
+_FILESYSTEM_END
\ No newline at end of file
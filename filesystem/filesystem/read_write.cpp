@@ -6,10 +6,6 @@
 #include <filesystem_pch.hpp>
 #include <filesystem.hpp>
 
-#if !_HAS_WINDOWS
-#pragma message("The contents of <read_write.cpp> are available only with Windows 10.")
-#else // ^^^ !_HAS_WINDOWS ^^^ / vvv _HAS_WINDOWS vvv
-
 _FILESYSTEM_BEGIN
 // FUNCTION clear
 _NODISCARD bool clear(const path& _Target) { // if directory, removes everything inside _Target, otherwise clears file
@@ -18,13 +14,17 @@ _NODISCARD bool clear(const path& _Target) { // if directory, removes everything
         if (_Is_directory(_Target)) {
             // don't use remove_all(), because it will remove _Target as well
             const directory_data _Dir(_Target);
+            path_builder _Builder(_Target); // creates full path to each element
             for (const auto& _Elem : _Dir.total()) { // remove one by one if _Target is directory
-                if (_Is_directory(_Target + R"(\)" + _Elem) && !is_empty(_Target + R"(\)" + _Elem)) { // non-empty directory
+                const path& _Precise{_Builder.push(_Elem).get()};
+                if (_Is_directory(_Precise) && !is_empty(_Precise)) { // non-empty directory
                     // If we don't check if directory is empty and won't be, remove() will throw an exception.
-                    (void) remove_all(_Target + R"(\)" + _Elem);
+                    (void) remove_all(_Precise);
                 } else { // regular file or empty directory
-                    (void) remove(_Target + R"(\)" + _Elem);
+                    (void) remove(_Precise);
                 }
+
+                _Builder.pop();
             }
 
             _FILESYSTEM_VERIFY(is_empty(_Target), "failed to clear the directory", error_type::runtime_error);
@@ -56,7 +56,7 @@ _NODISCARD vector<string> read_all(const path& _Target) { // reads all lines in
         vector<string> _All;
         string _Buff;
 
-        _Stream.open(_Target.generic_wstring());
+        _Stream.open(_Target.c_str()); // native encoding on each platform
         _FILESYSTEM_VERIFY_FILE_STREAM(_Stream);
 
         while (!_Stream.eof()) {
@@ -100,7 +100,7 @@ _NODISCARD string read_front(const path& _Target) { // reads first line in _Targ
         ifstream _Stream;
         string _Buff;
 
-        _Stream.open(_Target.generic_wstring());
+        _Stream.open(_Target.c_str()); // native encoding on each platform
         _FILESYSTEM_VERIFY_FILE_STREAM(_Stream);
 
         _STD getline(_Stream, _Buff);
@@ -127,8 +127,8 @@ _NODISCARD string read_inside(const path& _Target, const uintmax_t _Line) { // r
 // FUNCTION read_junction
 _NODISCARD path read_junction(const path& _Target) {
     _FILESYSTEM_VERIFY(is_junction(_Target), "expected a junction", error_type::runtime_error);
-
-    const HANDLE _Handle{CreateFileW(_Target.generic_wstring().c_str(),
+#if _HAS_WINDOWS
+    const HANDLE _Handle{CreateFileW(_Target.c_str(),
         static_cast<unsigned long>(file_access::readonly | file_access::writeonly), 0, nullptr,
         static_cast<unsigned long>(file_disposition::only_if_exists), static_cast<unsigned long>(
             file_flags::backup_semantics | file_flags::open_reparse_point), nullptr)};
@@ -162,8 +162,13 @@ _NODISCARD path read_junction(const path& _Target) {
     }
 
     return path(_Reparse);
+#else // ^^^ _HAS_WINDOWS ^^^ / vvv !_HAS_WINDOWS vvv
+    // junctions never exist on Linux, so the verification above always fails
+    return path();
+#endif // _HAS_WINDOWS
 }
 
+#if _HAS_WINDOWS
 // FUNCTION read_shortcut
 _NODISCARD path read_shortcut(const path& _Target) {
     _FILESYSTEM_VERIFY(exists(_Target), "shortcut not found", error_type::runtime_error);
@@ -177,7 +182,7 @@ _NODISCARD path read_shortcut(const path& _Target) {
     IPersistFile* _File      = {};
     wchar_t _Buff[_Max_path] = {}; // buffer for shortcut target path
     _FILESYSTEM_VERIFY_COM_RESULT(_Link->QueryInterface(IID_IPersistFile, reinterpret_cast<void**>(&_File)), _Link);
-    _FILESYSTEM_VERIFY_COM_RESULT(_File->Load(_Target.generic_wstring().c_str(), STGM_READ), _Link);
+    _FILESYSTEM_VERIFY_COM_RESULT(_File->Load(_Target.c_str(), STGM_READ), _Link);
     _FILESYSTEM_VERIFY_COM_RESULT(_Link->Resolve(nullptr, 0), _Link);
     _FILESYSTEM_VERIFY_COM_RESULT(_Link->GetPath(_Buff, _Max_path, &_Data, SLGP_SHORTPATH), _Link);
     _File->Release();
@@ -187,11 +192,13 @@ _NODISCARD path read_shortcut(const path& _Target) {
 
 #pragma warning(push, 1)
 #pragma warning(disable : 4067) // C4067: token after preprocessor directive (?)
+#endif // _HAS_WINDOWS
 // FUNCTION read_symlink
 _NODISCARD path read_symlink(const path& _Target) { // returns full path to target of symbolic link
     _FILESYSTEM_VERIFY(is_symlink(_Target), "expected a symbolic link", error_type::runtime_error);
+#if _HAS_WINDOWS
 
-    const HANDLE _Handle{CreateFileW(_Target.generic_wstring().c_str(),
+    const HANDLE _Handle{CreateFileW(_Target.c_str(),
         static_cast<unsigned long>(file_access::readonly), static_cast<unsigned long>(file_share::read), nullptr,
         static_cast<unsigned long>(file_disposition::only_if_exists), static_cast<unsigned long>(
             file_flags::backup_semantics | file_flags::open_reparse_point), nullptr)};
@@ -233,16 +240,29 @@ _NODISCARD path read_symlink(const path& _Target) { // returns full path to targ
     }
 
     return path(_Reparse);
+#else // ^^^ _HAS_WINDOWS ^^^ / vvv !_HAS_WINDOWS vvv
+    char _Buff[_Max_path + 1];
+    const ssize_t _Size{::readlink(_Target.c_str(), _Buff, sizeof(_Buff))};
+    _FILESYSTEM_VERIFY(_Size >= 0, "failed to read sybmolic link", error_type::runtime_error);
+    if (static_cast<size_t>(_Size) == sizeof(_Buff)) { // readlink() truncates silently, the target is too long
+        _Throw_system_error("read_symlink", "invalid length", error_type::length_error);
+    }
+
+    _Buff[_Size] = '\0'; // readlink() doesn't append null-terminator
+    return path(static_cast<const char*>(_Buff));
+#endif // _HAS_WINDOWS
 }
+#if _HAS_WINDOWS
 #pragma warning(default : 4067)
 #pragma warning(pop)
+#endif // _HAS_WINDOWS
 
 // FUNCTION resize_file
 _NODISCARD bool resize_file(const path& _Target, const size_t _Newsize) {
     _FILESYSTEM_VERIFY(exists(_Target), "file not found", error_type::runtime_error);
     _FILESYSTEM_VERIFY(!_Is_directory(_Target), "expected a file", error_type::runtime_error);
-
-    const HANDLE _Handle{CreateFileW(_Target.generic_wstring().c_str(),
+#if _HAS_WINDOWS
+    const HANDLE _Handle{CreateFileW(_Target.c_str(),
         static_cast<unsigned long>(file_access::writeonly), static_cast<unsigned long>(file_share::read
             | file_share::write | file_share::remove), nullptr, static_cast<unsigned long>(file_disposition::only_if_exists),
         static_cast<unsigned long>(file_attributes::none), nullptr)};
@@ -257,12 +277,256 @@ _NODISCARD bool resize_file(const path& _Target, const size_t _Newsize) {
     }
 
     CloseHandle(_Handle);
+#else // ^^^ _HAS_WINDOWS ^^^ / vvv !_HAS_WINDOWS vvv
+    _FILESYSTEM_VERIFY(::truncate(_Target.c_str(), static_cast<off_t>(_Newsize)) == 0,
+        "failed to resize file", error_type::runtime_error);
+#endif // _HAS_WINDOWS
     return true;
 }
 
+// CONSTANT _Transcode_chunk_size
+inline constexpr size_t _Transcode_chunk_size = 256 * 1024; // bytes read at once, small enough for the L2 cache
+
+// STRUCT _Bom_entry
+struct _Bom_entry {
+    text_encoding _Encoding;
+    string_view _Bom;
+};
+
+// CONSTANT _Boms
+inline constexpr _Bom_entry _Boms[] = { // UTF-32LE first, its BOM starts with the UTF-16LE BOM
+    {text_encoding::utf32le, string_view{"\xFF\xFE\0\0", 4}},
+    {text_encoding::utf32be, string_view{"\0\0\xFE\xFF", 4}},
+    {text_encoding::utf8, string_view{"\xEF\xBB\xBF", 3}},
+    {text_encoding::utf16le, string_view{"\xFF\xFE", 2}},
+    {text_encoding::utf16be, string_view{"\xFE\xFF", 2}}
+};
+
+// FUNCTION _Code_unit_size
+_NODISCARD constexpr size_t _Code_unit_size(const text_encoding _Encoding) noexcept {
+    switch (_Encoding) {
+    case text_encoding::utf16le:
+    case text_encoding::utf16be:
+        return 2;
+    case text_encoding::utf32le:
+    case text_encoding::utf32be:
+        return 4;
+    default:
+        return 1;
+    }
+}
+
+// FUNCTION _Is_big_endian
+_NODISCARD constexpr bool _Is_big_endian(const text_encoding _Encoding) noexcept {
+    return _Encoding == text_encoding::utf16be || _Encoding == text_encoding::utf32be;
+}
+
+// FUNCTION _Skip_bom
+_NODISCARD size_t _Skip_bom(const string_view _Text, text_encoding& _Encoding) noexcept {
+    // returns the size of the BOM that matches _Encoding, resolves text_encoding::detect
+    for (const _Bom_entry& _Entry : _Boms) {
+        if ((_Encoding == text_encoding::detect || _Encoding == _Entry._Encoding) && _Text.starts_with(_Entry._Bom)) {
+            _Encoding = _Entry._Encoding;
+            return _Entry._Bom.size();
+        }
+    }
+
+    if (_Encoding == text_encoding::detect) { // no BOM, assume UTF-8
+        _Encoding = text_encoding::utf8;
+    }
+
+    return 0;
+}
+
+// FUNCTION _Complete_size
+_NODISCARD size_t _Complete_size(const string_view _Text, const text_encoding _Encoding) noexcept {
+    // returns the size of the longest prefix of _Text that ends with a whole code point
+    const size_t _Unit{_Code_unit_size(_Encoding)};
+    const size_t _Whole{_Text.size() - _Text.size() % _Unit};
+    if (_Unit == 1) { // step back over the last incomplete sequence (at most 3 bytes)
+        for (size_t _Back = 1; _Back <= 3 && _Back <= _Whole; ++_Back) {
+            const unsigned char _Byte{static_cast<unsigned char>(_Text[_Whole - _Back])};
+            if ((_Byte & 0xC0) != 0x80) { // ASCII or lead byte
+                const size_t _Length{_Byte >= 0xF0 ? 4U : _Byte >= 0xE0 ? 3U : _Byte >= 0xC0 ? 2U : 1U};
+                return _Length > _Back ? _Whole - _Back : _Whole;
+            }
+        }
+    } else if (_Unit == 2 && _Whole >= 2) { // a high surrogate needs the next code unit
+        const unsigned char _High{static_cast<unsigned char>(_Text[_Is_big_endian(_Encoding) ? _Whole - 2 : _Whole - 1])};
+        if ((_High & 0xFC) == 0xD8) {
+            return _Whole - 2;
+        }
+    }
+
+    return _Whole; // invalid sequences are left for the conversion to report
+}
+
+// FUNCTION TEMPLATE _Swap_bytes
+template <class _Elem>
+void _Swap_bytes(_Elem* const _First, const size_t _Count) noexcept {
+    for (size_t _Idx = 0; _Idx < _Count; ++_Idx) { // simple enough to be vectorized by the compiler
+        const _Elem _Unit{_First[_Idx]};
+        if constexpr (sizeof(_Elem) == 2) {
+            _First[_Idx] = static_cast<_Elem>((_Unit >> 8) | (_Unit << 8));
+        } else {
+            _First[_Idx] = static_cast<_Elem>(
+                (_Unit >> 24) | ((_Unit >> 8) & 0xFF00) | ((_Unit << 8) & 0xFF0000) | (_Unit << 24));
+        }
+    }
+}
+
+// CLASS _Chunk_transcoder
+class _Chunk_transcoder { // converts whole code points between encodings, owns the buffers for one file
+public:
+    _Chunk_transcoder(const text_encoding _Source, const text_encoding _Target) noexcept
+        : _Mysource(_Source), _Mytarget(_Target), _Mymiddle(), _Myunits16(), _Myunits32() {}
+
+    // converts _Chunk (whole code points only), returns the result as bytes
+    _NODISCARD string_view _Convert(const string_view _Chunk) {
+        const string_view _Utf8{_To_utf8(_Chunk)};
+        switch (_Code_unit_size(_Mytarget)) {
+        case 2:
+            return _From_utf8(_Utf8, _Myunits16);
+        case 4:
+            return _From_utf8(_Utf8, _Myunits32);
+        default:
+            return _Utf8;
+        }
+    }
+
+private:
+    // decodes _Chunk to UTF-8 (no-op for UTF-8 source)
+    _NODISCARD string_view _To_utf8(const string_view _Chunk) {
+        switch (_Code_unit_size(_Mysource)) {
+        case 2:
+            return _Units_to_utf8(_Chunk, _Myunits16);
+        case 4:
+            return _Units_to_utf8(_Chunk, _Myunits32);
+        default:
+            return _Chunk;
+        }
+    }
+
+    template <class _Elem>
+    _NODISCARD string_view _Units_to_utf8(const string_view _Chunk, vector<_Elem>& _Units) {
+        const size_t _Count{_Chunk.size() / sizeof(_Elem)};
+        _Units.resize(_Count);
+        _CSTD memcpy(_Units.data(), _Chunk.data(), _Chunk.size()); // the chunk may be unaligned
+        if (_Is_big_endian(_Mysource) != (_STD endian::native == _STD endian::big)) {
+            _Swap_bytes(_Units.data(), _Count);
+        }
+
+        _Mymiddle.resize(_Count * (sizeof(_Elem) == 2 ? 3 : 4)); // the worst case per code unit
+        const size_t _Size{_Utf_to_utf8(_Units.data(), _Count, _Mymiddle.data(), true)};
+        if (_Size == _Transcode_error) {
+            _Throw_system_error("transcode_file", "invalid source text", error_type::runtime_error);
+        }
+
+        return string_view{_Mymiddle.data(), _Size};
+    }
+
+    template <class _Elem>
+    _NODISCARD string_view _From_utf8(const string_view _Utf8, vector<_Elem>& _Units) {
+        _Units.resize(_Utf8.size()); // never more code units than UTF-8 bytes
+        const size_t _Count{_Utf8_to_utf(_Utf8.data(), _Utf8.size(), _Units.data(), true)};
+        if (_Count == _Transcode_error) {
+            _Throw_system_error("transcode_file", "invalid source text", error_type::runtime_error);
+        }
+
+        if (_Is_big_endian(_Mytarget) != (_STD endian::native == _STD endian::big)) {
+            _Swap_bytes(_Units.data(), _Count);
+        }
+
+        return string_view{reinterpret_cast<const char*>(_Units.data()), _Count * sizeof(_Elem)};
+    }
+
+    text_encoding _Mysource;
+    text_encoding _Mytarget;
+    vector<char> _Mymiddle; // UTF-8 form of non-UTF-8 source
+    vector<char16_t> _Myunits16; // UTF-16 code units (source or target)
+    vector<char32_t> _Myunits32; // UTF-32 code units (source or target)
+};
+
+// FUNCTION _Transcode_stream
+void _Transcode_stream(ifstream& _Input, ofstream& _Output, const text_encoding _Source,
+    const text_encoding _Target, const bool _Write_bom) {
+    vector<char> _Buff(_Transcode_chunk_size + 4); // a chunk and a carried incomplete code point
+    size_t _Carried{0};
+    text_encoding _Encoding{_Source};
+    _Chunk_transcoder _Transcoder{text_encoding::utf8, _Target}; // replaced once the source encoding is known
+    bool _First_chunk{true};
+    for (;;) {
+        _Input.read(_Buff.data() + _Carried, static_cast<_STD streamsize>(_Transcode_chunk_size));
+        const bool _End{_Input.eof()};
+        _FILESYSTEM_VERIFY(_End || _Input.good(), "failed to read the file", error_type::runtime_error);
+        string_view _Chunk{_Buff.data(), _Carried + static_cast<size_t>(_Input.gcount())};
+        if (_First_chunk) { // the BOM can be only at the beginning
+            _First_chunk = false;
+            _Chunk.remove_prefix(_Skip_bom(_Chunk, _Encoding));
+            _Transcoder = _Chunk_transcoder{_Encoding, _Target};
+            if (_Write_bom) {
+                for (const _Bom_entry& _Entry : _Boms) {
+                    if (_Entry._Encoding == _Target) {
+                        _Output.write(_Entry._Bom.data(), static_cast<_STD streamsize>(_Entry._Bom.size()));
+                        break;
+                    }
+                }
+            }
+        }
+
+        const size_t _Size{_Complete_size(_Chunk, _Encoding)};
+        const string_view _Converted{
+            _Encoding == _Target ? _Chunk.substr(0, _Size) : _Transcoder._Convert(_Chunk.substr(0, _Size))};
+        _Output.write(_Converted.data(), static_cast<_STD streamsize>(_Converted.size()));
+        _FILESYSTEM_VERIFY(_Output.good(), "failed to write the file", error_type::runtime_error);
+
+        // move the incomplete code point to the beginning, the next chunk will complete it
+        _Carried = _Chunk.size() - _Size;
+        _CSTD memmove(_Buff.data(), _Chunk.data() + _Size, _Carried);
+        if (_End) {
+            if (_Carried != 0) { // reported like any other invalid text
+                _Throw_system_error("transcode_file", "invalid source text", error_type::runtime_error);
+            }
+
+            break;
+        }
+    }
+}
+
+// FUNCTION transcode_file
+_NODISCARD bool transcode_file(const path& _From, const path& _To, const text_encoding _Source,
+    const text_encoding _Target, const bool _Write_bom) {
+    _FILESYSTEM_VERIFY(exists(_From), "file not found", error_type::runtime_error);
+    _FILESYSTEM_VERIFY(!_Is_directory(_From), "expected a file", error_type::runtime_error);
+    _FILESYSTEM_VERIFY(_Target != text_encoding::detect, "invalid target encoding", error_type::invalid_argument);
+
+    // the result is written next to the target and renamed at the end, so a failure never leaves
+    // a partially written target and the source may be the target itself
+    const path _Temp{_To + ".transcode.tmp"};
+    _TRY_BEGIN
+    ifstream _Input(_From.c_str(), ios::binary);
+    _FILESYSTEM_VERIFY_FILE_STREAM(_Input);
+    ofstream _Output(_Temp.c_str(), ios::binary | ios::trunc);
+    _FILESYSTEM_VERIFY_FILE_STREAM(_Output);
+    _Transcode_stream(_Input, _Output, _Source, _Target, _Write_bom);
+    _Input.close(); // Windows cannot replace the source while it's open
+    _Output.close();
+    _FILESYSTEM_VERIFY(!_Output.fail(), "failed to write the file", error_type::runtime_error);
+    _CATCH_ALL
+#if _HAS_WINDOWS
+    DeleteFileW(_Temp.c_str()); // may not exist yet
+#else // ^^^ _HAS_WINDOWS ^^^ / vvv !_HAS_WINDOWS vvv
+    ::unlink(_Temp.c_str()); // may not exist yet
+#endif // _HAS_WINDOWS
+    _RERAISE;
+    _CATCH_END
+
+    return rename(_Temp, _To, rename_options::replace);
+}
+
 // FUNCTION TEMPLATE write_back
 template <class _CharTy>
-_NODISCARD constexpr bool write_back(const path& _Target, const _CharTy* const _Writable) {
+_NODISCARD bool write_back(const path& _Target, const _CharTy* const _Writable) {
     _FILESYSTEM_VERIFY(exists(_Target), "file not found", error_type::runtime_error);
     _FILESYSTEM_VERIFY(!_Is_directory(_Target), "expected a file", error_type::runtime_error);
 
@@ -271,7 +535,7 @@ _NODISCARD constexpr bool write_back(const path& _Target, const _CharTy* const _
         _Convert_to_narrow<_CharTy, char_traits<_CharTy>>(_Writable)
         : "\n" + _Convert_to_narrow<_CharTy, char_traits<_CharTy>>(_Writable);
     ofstream _Stream;
-    _Stream.open(_Target.generic_string(), ios::ate | ios::in | ios::out); // without ios::in, all content will be removed
+    _Stream.open(_Target.c_str(), ios::ate | ios::in | ios::out); // without ios::in, all content will be removed
     _FILESYSTEM_VERIFY_FILE_STREAM(_Stream);
 
     _Stream.write(_Correct.c_str(), _Correct.size());
@@ -292,7 +556,7 @@ template _FILESYSTEM_API _NODISCARD bool write_back(const path&, const wchar_t*
 
 // FUNCTION TEMPLATE write_front
 template <class _CharTy>
-_NODISCARD constexpr bool write_front(const path& _Target, const _CharTy* const _Writable) {
+_NODISCARD bool write_front(const path& _Target, const _CharTy* const _Writable) {
     _FILESYSTEM_VERIFY(exists(_Target), "file not found", error_type::runtime_error);
     _FILESYSTEM_VERIFY(!_Is_directory(_Target), "expected a file", error_type::runtime_error);
 
@@ -334,7 +598,7 @@ template _FILESYSTEM_API _NODISCARD bool write_front(const path&, const wchar_t*
 
 // FUNCTION TEMPLATE write_inside
 template <class _CharTy>
-_NODISCARD constexpr bool write_inside(const path& _Target, const _CharTy* const _Writable, const uintmax_t _Line) {
+_NODISCARD bool write_inside(const path& _Target, const _CharTy* const _Writable, const uintmax_t _Line) {
     _FILESYSTEM_VERIFY(exists(_Target), "file not found", error_type::runtime_error);
     _FILESYSTEM_VERIFY(!_Is_directory(_Target), "expected a file", error_type::runtime_error);
     const auto& _All    = read_all(_Target);
@@ -385,7 +649,7 @@ template _FILESYSTEM_API _NODISCARD bool write_inside(const path& _Target, const
 
 // FUNCTION TEMPLATE write_instead
 template <class _CharTy>
-_NODISCARD constexpr bool write_instead(const path& _Target, const _CharTy* const _Writable, const uintmax_t _Line) {
+_NODISCARD bool write_instead(const path& _Target, const _CharTy* const _Writable, const uintmax_t _Line) {
     _FILESYSTEM_VERIFY(exists(_Target), "file not found", error_type::runtime_error);
     _FILESYSTEM_VERIFY(!_Is_directory(_Target), "expected a file", error_type::runtime_error);
     const string& _Narrow_writable = _Convert_to_narrow<_CharTy, char_traits<_CharTy>>(_Writable);
@@ -416,6 +680,4 @@ template _FILESYSTEM_API _NODISCARD bool write_instead(const path& _Target, cons
 template _FILESYSTEM_API _NODISCARD bool write_instead(const path& _Target, const char16_t* const, const uintmax_t);
 template _FILESYSTEM_API _NODISCARD bool write_instead(const path& _Target, const char32_t* const, const uintmax_t);
 template _FILESYSTEM_API _NODISCARD bool write_instead(const path& _Target, const wchar_t* const, const uintmax_t);
-_FILESYSTEM_END
-
-#endif // !_HAS_WINDOWS
\ No newline at end of file
+_FILESYSTEM_END
\ No newline at end of file
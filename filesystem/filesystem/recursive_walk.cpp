@@ -0,0 +1,393 @@
+// recursive_walk.cpp
+
+// Copyright (c) Mateusz Jandura. All rights reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#include <filesystem_pch.hpp>
+#include <filesystem.hpp>
+#include <algorithm>
+#include <atomic>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <unordered_set>
+
+_FILESYSTEM_BEGIN
+// STRUCT _Walk_task
+struct _Walk_task { // a directory that waits to be read
+    path _Path; // the root joined with the names of all parents and the directory
+    size_t _Depth; // depth of its entries
+#if !_HAS_WINDOWS
+    _STD shared_ptr<_Unique_descriptor> _Parent; // the open parent, nullptr for the root
+    size_t _Name_offset; // position of the name inside _Path, the name is opened relative to _Parent
+    bool _Follow; // true if the directory may be a symbolic link that should be followed
+#endif // !_HAS_WINDOWS
+};
+
+// STRUCT _Walk_queue
+struct alignas(64) _Walk_queue { // tasks of one worker, the owner takes the newest, thieves take the oldest
+    _STD mutex _Mutex;
+    _STD deque<_Walk_task> _Tasks;
+};
+
+// CLASS _Walker
+class _Walker { // shares the tree between workers, each worker has its own queue
+public:
+    explicit _Walker(const _STD function<walk_action(const walk_entry&)>& _Visitor,
+        const walk_options& _Options, const size_t _Workers)
+        : _Myvisitor(_Visitor), _Myoptions(_Options), _Myqueues(_Workers), _Mypending(0), _Mysignal(0),
+        _Mystopped(false), _Myerror(), _Myerror_mutex(), _Myids(), _Myids_mutex() {}
+
+    _Walker(const _Walker&)            = delete;
+    _Walker& operator=(const _Walker&) = delete;
+
+    // walks the whole tree, rethrows the first exception from any worker
+    void _Run(const path& _Root) {
+#if _HAS_WINDOWS
+        _Push(0, _Walk_task{_Root, 0});
+#else // ^^^ _HAS_WINDOWS ^^^ / vvv !_HAS_WINDOWS vvv
+        _Push(0, _Walk_task{_Root, 0, nullptr, 0, true}); // the root is always followed
+#endif // _HAS_WINDOWS
+
+        vector<_STD thread> _Threads;
+        if (_Myqueues.size() > 1) {
+            _Threads.reserve(_Myqueues.size() - 1);
+            _TRY_BEGIN
+            for (size_t _Idx = 1; _Idx < _Myqueues.size(); ++_Idx) {
+                _Threads.emplace_back(&_Walker::_Work, this, _Idx);
+            }
+            _CATCH_ALL
+            // failed to start a thread, the started ones and the calling thread will do everything
+            _CATCH_END
+        }
+
+        _Work(0); // the calling thread is a worker as well
+        for (_STD thread& _Thread : _Threads) {
+            _Thread.join();
+        }
+
+        if (_Myerror) {
+            _STD rethrow_exception(_Myerror);
+        }
+    }
+
+private:
+    // registers the directory _Id, returns false if it was already entered (a cycle or another link to it)
+    _NODISCARD bool _Enter(const file_id& _Id) {
+        const _STD lock_guard<_STD mutex> _Guard(_Myids_mutex);
+        return _Myids.insert(_Id).second;
+    }
+
+    // remembers the first exception and stops all workers
+    void _Fail(const _STD exception_ptr _Error) noexcept {
+        const _STD lock_guard<_STD mutex> _Guard(_Myerror_mutex);
+        if (!_Myerror) {
+            _Myerror = _Error;
+        }
+
+        _Mystopped.store(true);
+    }
+
+    // checks if links of any kind are followed, only then cycles are possible
+    _NODISCARD bool _Follows_links() const noexcept {
+#if _HAS_WINDOWS
+        return _Myoptions.follow_symlinks || _Myoptions.follow_junctions;
+#else // ^^^ _HAS_WINDOWS ^^^ / vvv !_HAS_WINDOWS vvv
+        return _Myoptions.follow_symlinks;
+#endif // _HAS_WINDOWS
+    }
+
+#if _HAS_WINDOWS
+    // fills the info of _Entry, with skip_inaccessible an inaccessible entry is visited without it
+    void _Fetch_info(walk_entry& _Entry) const {
+        _TRY_BEGIN
+        _Entry.has_info = _Try_info(_Entry.target, false, _Entry.info);
+        _CATCH(const filesystem_error&)
+        if (!_Myoptions.skip_inaccessible) {
+            _RERAISE;
+        }
+
+        _Entry.has_info = false; // e.g. ERROR_ACCESS_DENIED or ERROR_SHARING_VIOLATION
+        _CATCH_END
+    }
+#else // ^^^ _HAS_WINDOWS ^^^ / vvv !_HAS_WINDOWS vvv
+    // fills the info of _Entry, with skip_inaccessible an inaccessible entry is visited without it
+    void _Fetch_info(walk_entry& _Entry, const int _Dirfd, const char* const _Name) const {
+        _TRY_BEGIN
+        _Entry.has_info = _Try_info_at(_Dirfd, _Name, false, _Entry.info);
+        _CATCH(const filesystem_error&)
+        if (!_Myoptions.skip_inaccessible) {
+            _RERAISE;
+        }
+
+        _Entry.has_info = false; // e.g. EACCES
+        _CATCH_END
+    }
+
+    // reads the next entry, with skip_inaccessible a failure ends the directory instead of the walk
+    _NODISCARD const _Linux_dirent64* _Next_entry(_Directory_reader& _Reader) const {
+        _TRY_BEGIN
+        return _Reader._Next();
+        _CATCH(const filesystem_error&)
+        if (!_Myoptions.skip_inaccessible) {
+            _RERAISE;
+        }
+        _CATCH_END
+
+        return nullptr;
+    }
+#endif // _HAS_WINDOWS
+
+    // takes the newest own task, or steals the oldest task of another worker
+    _NODISCARD bool _Pop(const size_t _Self, _Walk_task& _Task) {
+        {
+            _Walk_queue& _Queue{_Myqueues[_Self]};
+            const _STD lock_guard<_STD mutex> _Guard(_Queue._Mutex);
+            if (!_Queue._Tasks.empty()) { // depth-first, so only a few directories per worker are open
+                _Task = _STD move(_Queue._Tasks.back());
+                _Queue._Tasks.pop_back();
+                return true;
+            }
+        }
+
+        for (size_t _Offset = 1; _Offset < _Myqueues.size(); ++_Offset) {
+            _Walk_queue& _Queue{_Myqueues[(_Self + _Offset) % _Myqueues.size()]};
+            const _STD lock_guard<_STD mutex> _Guard(_Queue._Mutex);
+            if (!_Queue._Tasks.empty()) { // the oldest task is the closest to the root, so it's the biggest one
+                _Task = _STD move(_Queue._Tasks.front());
+                _Queue._Tasks.pop_front();
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    // reads the directory of _Task, visits its entries and queues its subdirectories
+    void _Process(const size_t _Self, const _Walk_task& _Task) {
+        walk_entry _Entry{};
+        _Entry.depth = _Task._Depth;
+#if _HAS_WINDOWS
+        if (_Follows_links()) {
+            file_info _Info;
+            bool _Found{false};
+            _TRY_BEGIN
+            _Found = _Try_info(_Task._Path, true, _Info);
+            _CATCH(const filesystem_error&)
+            if (!_Myoptions.skip_inaccessible) {
+                _RERAISE;
+            }
+            _CATCH_END
+
+            if (!_Found || !_Enter(_Info.id)) { // removed, inaccessible or already entered
+                return;
+            }
+        }
+
+        WIN32_FIND_DATAW _Data = WIN32_FIND_DATAW();
+        const HANDLE _Handle   = FindFirstFileExW(path_builder(_Task._Path).push("*").get().c_str(),
+            FindExInfoBasic, &_Data, FindExSearchNameMatch, nullptr, FIND_FIRST_EX_LARGE_FETCH);
+        if (_Handle == INVALID_HANDLE_VALUE) {
+            const unsigned long _Error{GetLastError()};
+            if (_Task._Depth != 0 && (_Error == ERROR_FILE_NOT_FOUND || _Error == ERROR_PATH_NOT_FOUND
+                || _Error == ERROR_DIRECTORY || _Myoptions.skip_inaccessible)) { // removed, not a directory or skipped
+                return;
+            }
+
+            _Throw_fs_error("failed to read the directory", error_type::runtime_error, "recursive_walk");
+        }
+
+        _TRY_BEGIN
+        path_builder _Builder(_Task._Path);
+        do {
+            const wchar_t* const _Name{_Data.cFileName};
+            if (_Name[0] == L'.' && (_Name[1] == L'\0' || (_Name[1] == L'.' && _Name[2] == L'\0'))) { // skip dots
+                continue;
+            }
+
+            if (_Mystopped.load(_STD memory_order_relaxed)) {
+                break;
+            }
+
+            _TRY_BEGIN
+            _Entry.target = _Builder.push(path{_Name}).get();
+            _CATCH(const _STD length_error&)
+            continue; // longer than _Max_path, it cannot be stored in path, so only this entry is skipped
+            _CATCH_END
+            _Builder.pop();
+            _Entry.type     = _File_type_from_find_data(_Data);
+            _Entry.has_info = false;
+            if (_Myoptions.fetch_info) {
+                _Fetch_info(_Entry);
+            }
+
+            const walk_action _Action{_Myvisitor(_Entry)};
+            if (_Action == walk_action::stop) {
+                _Mystopped.store(true);
+                break;
+            }
+
+            // links to directories have FILE_ATTRIBUTE_DIRECTORY, junctions always point to directories
+            const bool _Enters{_Entry.type == file_type::directory
+                || (_Entry.type == file_type::symlink && _Myoptions.follow_symlinks
+                    && (_Data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) != 0)
+                || (_Entry.type == file_type::junction && _Myoptions.follow_junctions)};
+            if (_Action == walk_action::proceed && _Enters && _Task._Depth < _Myoptions.max_depth) {
+                _Push(_Self, _Walk_task{_STD move(_Entry.target), _Task._Depth + 1});
+            }
+        } while (FindNextFileW(_Handle, &_Data));
+        _CATCH_ALL
+        FindClose(_Handle);
+        _RERAISE;
+        _CATCH_END
+
+        FindClose(_Handle);
+#else // ^^^ _HAS_WINDOWS ^^^ / vvv !_HAS_WINDOWS vvv
+        // opened relative to the parent, so the kernel doesn't resolve the whole path again
+        const int _Parent_fd{_Task._Parent ? _Task._Parent->_Get() : AT_FDCWD};
+        const char* const _Dir_name{_Task._Path.c_str() + _Task._Name_offset};
+        const auto _Dir{_STD make_shared<_Unique_descriptor>(_Task._Follow
+            ? ::openat(_Parent_fd, _Dir_name, O_RDONLY | O_DIRECTORY | O_CLOEXEC) : _Open_directory(_Parent_fd, _Dir_name))};
+        if (_Dir->_Get() == -1) {
+            if (_Task._Depth != 0 && (errno == ENOENT || errno == ENOTDIR || errno == ELOOP
+                || _Myoptions.skip_inaccessible)) { // removed, not a directory (anymore) or skipped
+                return;
+            }
+
+            _Throw_fs_error("failed to read the directory", error_type::runtime_error, "recursive_walk");
+        }
+
+        if (_Follows_links()) {
+            struct statx _Stat;
+            if (::statx(_Dir->_Get(), "", AT_EMPTY_PATH, STATX_INO, &_Stat) != 0) {
+                if (_Myoptions.skip_inaccessible) {
+                    return;
+                }
+
+                _Throw_fs_error("failed to get informations", error_type::runtime_error, "recursive_walk");
+            }
+
+            // the same id as info() returns
+            file_id _Id{};
+            const uint64_t _Inode{_Stat.stx_ino};
+            _Id._Volume_serial_number = (static_cast<uint64_t>(_Stat.stx_dev_major) << 32) | _Stat.stx_dev_minor;
+            _CSTD memcpy(_Id._Id, &_Inode, sizeof(_Inode));
+            if (!_Enter(_Id)) { // already entered
+                return;
+            }
+        }
+
+        _Directory_reader _Reader{_Dir->_Get()};
+        path_builder _Builder(_Task._Path);
+        while (const _Linux_dirent64* const _Raw = _Next_entry(_Reader)) {
+            if (_Mystopped.load(_STD memory_order_relaxed)) {
+                break;
+            }
+
+            _TRY_BEGIN
+            _Entry.target = _Builder.push(static_cast<const char*>(_Raw->_Name)).get();
+            _CATCH(const _STD length_error&)
+            continue; // longer than _Max_path, it cannot be stored in path, so only this entry is skipped
+            _CATCH_END
+            _Builder.pop();
+            _Entry.type     = _File_type_from_dirent(_Dir->_Get(), *_Raw);
+            _Entry.has_info = false;
+            if (_Myoptions.fetch_info) {
+                _Fetch_info(_Entry, _Dir->_Get(), _Raw->_Name);
+            }
+
+            const walk_action _Action{_Myvisitor(_Entry)};
+            if (_Action == walk_action::stop) {
+                _Mystopped.store(true);
+                break;
+            }
+
+            const bool _Link{_Entry.type == file_type::symlink && _Myoptions.follow_symlinks};
+            if (_Action == walk_action::proceed && (_Entry.type == file_type::directory || _Link)
+                && _Task._Depth < _Myoptions.max_depth) {
+                const size_t _Name_offset{_Entry.target.size() - _CSTD strlen(_Raw->_Name)};
+                _Push(_Self, _Walk_task{_STD move(_Entry.target), _Task._Depth + 1, _Dir, _Name_offset, _Link});
+            }
+        }
+#endif // _HAS_WINDOWS
+    }
+
+    // queues _Task in the queue of _Self
+    void _Push(const size_t _Self, _Walk_task&& _Task) {
+        _Mypending.fetch_add(1); // before the task is visible, so no worker can see zero while it waits
+        _TRY_BEGIN
+        _Walk_queue& _Queue{_Myqueues[_Self]};
+        const _STD lock_guard<_STD mutex> _Guard(_Queue._Mutex);
+        _Queue._Tasks.push_back(_STD move(_Task));
+        _CATCH_ALL
+        if (_Mypending.fetch_sub(1) == 1) { // the task was never queued, don't leave idle workers waiting for it
+            _Mysignal.fetch_add(1);
+            _Mysignal.notify_all();
+        }
+
+        _RERAISE;
+        _CATCH_END
+
+        _Mysignal.fetch_add(1); // wake up one idle worker to steal it
+        _Mysignal.notify_one();
+    }
+
+    // processes tasks until all directories are read
+    void _Work(const size_t _Self) noexcept {
+        _Walk_task _Task{};
+        for (;;) {
+            // read before looking for a task, so that a task queued afterwards never leaves this worker asleep
+            const uint32_t _Signal{_Mysignal.load()};
+            if (_Mypending.load() == 0) {
+                break;
+            }
+
+            bool _Found{false};
+            _TRY_BEGIN
+            _Found = _Pop(_Self, _Task);
+            if (_Found && !_Mystopped.load(_STD memory_order_relaxed)) { // after stop, only drain the queues
+                _Process(_Self, _Task);
+            }
+            _CATCH_ALL
+            _Fail(_STD current_exception());
+            _CATCH_END
+
+            if (!_Found) { // everything is taken, sleep until other workers queue more or finish
+                _Mysignal.wait(_Signal);
+                continue;
+            }
+
+            _Task = _Walk_task{}; // closes the parent if this was its last subdirectory
+            if (_Mypending.fetch_sub(1) == 1) { // after all subdirectories are queued, the last one wakes up everyone
+                _Mysignal.fetch_add(1);
+                _Mysignal.notify_all();
+            }
+        }
+    }
+
+    const _STD function<walk_action(const walk_entry&)>& _Myvisitor;
+    const walk_options& _Myoptions;
+    vector<_Walk_queue> _Myqueues; // one queue per worker
+    _STD atomic<size_t> _Mypending; // queued or processed tasks
+    _STD atomic<uint32_t> _Mysignal; // changed when a task is queued or the last one is done, idle workers wait on it
+    _STD atomic<bool> _Mystopped; // set by walk_action::stop or by the first exception
+    _STD exception_ptr _Myerror; // the first exception
+    _STD mutex _Myerror_mutex;
+    _STD unordered_set<file_id, _File_id_hash, _File_id_equal> _Myids; // entered directories, if links are followed
+    _STD mutex _Myids_mutex;
+};
+
+// FUNCTION recursive_walk
+void recursive_walk(const path& _Root, const _STD function<walk_action(const walk_entry&)>& _Visitor,
+    const walk_options& _Options) {
+    _FILESYSTEM_VERIFY(_Is_directory(_Root), "expected a directory", error_type::runtime_error);
+    size_t _Workers{_Options.threads};
+    if (_Workers == 0) {
+        _Workers = static_cast<size_t>((_STD max)(_STD thread::hardware_concurrency(), 1u));
+    }
+
+    _Walker _Walk(_Visitor, _Options, _Workers);
+    _Walk._Run(_Root);
+}
+_FILESYSTEM_END
\ No newline at end of file
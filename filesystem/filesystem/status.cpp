@@ -5,28 +5,90 @@
 
 #include <filesystem_pch.hpp>
 #include <filesystem.hpp>
+#include <algorithm>
+#include <atomic>
+#include <limits>
+#include <thread>
 
-#if !_HAS_WINDOWS
-#pragma message("The contents of <status.cpp> are available only with Windows 10.")
-#else // ^^^ !_HAS_WINDOWS ^^^ / vvv _HAS_WINDOWS vvv
+#if _HAS_WINDOWS
 #pragma warning(push)
 #pragma warning(disable : 4996) // C4996: using deprecated content
+#endif // _HAS_WINDOWS
 
 _FILESYSTEM_BEGIN
+// FUNCTION _Has_fields
+_NODISCARD constexpr bool _Has_fields(const _File_status_fields _Fields, const _File_status_fields _Expected) noexcept {
+    return (_Fields & _Expected) == _Expected;
+}
+
+#if _HAS_WINDOWS
+// FUNCTION _Reparse_tag
+_NODISCARD unsigned long _Reparse_tag(const path& _Target) noexcept {
+    // FindFirstFileExW() reports the reparse tag without opening the target, 0 means that the tag is unknown
+    WIN32_FIND_DATAW _Data;
+    const HANDLE _Handle{FindFirstFileExW(_Target.c_str(), FindExInfoBasic, &_Data, FindExSearchNameMatch, nullptr, 0)};
+    if (_Handle == INVALID_HANDLE_VALUE) {
+        return 0;
+    }
+
+    FindClose(_Handle);
+    return (_Data.dwFileAttributes & FILE_ATTRIBUTE_REPARSE_POINT) != 0 ? _Data.dwReserved0 : 0;
+}
+
+// CONSTANT _Filetime_unix_epoch
+inline constexpr int64_t _Filetime_unix_epoch = 116'444'736'000'000'000; // 1970-01-01 in 100 ns units since 1601-01-01
+
+// CONSTANT _Filetime_min
+inline constexpr int64_t _Filetime_min = _Filetime_unix_epoch + (_STD numeric_limits<int64_t>::min)() / 100;
+
+// CONSTANT _Filetime_max
+inline constexpr int64_t _Filetime_max = _Filetime_unix_epoch + (_STD numeric_limits<int64_t>::max)() / 100;
+
+// FUNCTION _File_clock_from_filetime
+_NODISCARD constexpr file_clock::time_point _File_clock_from_filetime(const FILETIME& _Time) noexcept {
+    // file_clock covers only the years 1678-2262, times outside (e.g. 0 for unknown) are clamped to its limits
+    const uint64_t _Ticks{(static_cast<uint64_t>(_Time.dwHighDateTime) << 32) | _Time.dwLowDateTime};
+    if (_Ticks < static_cast<uint64_t>(_Filetime_min)) {
+        return (file_clock::time_point::min)();
+    }
+
+    if (_Ticks > static_cast<uint64_t>(_Filetime_max)) {
+        return (file_clock::time_point::max)();
+    }
+
+    return file_clock::time_point{file_clock::duration{(static_cast<int64_t>(_Ticks) - _Filetime_unix_epoch) * 100}};
+}
+#endif // _HAS_WINDOWS
+
+// FUNCTION file_clock::now
+_NODISCARD file_clock::time_point file_clock::now() noexcept {
+    return from_sys(_STD chrono::system_clock::now());
+}
+
+// FUNCTION file_clock::from_sys
+_NODISCARD file_clock::time_point file_clock::from_sys(const _STD chrono::system_clock::time_point _Time) noexcept {
+    return time_point{_STD chrono::duration_cast<duration>(_Time.time_since_epoch())};
+}
+
+// FUNCTION file_clock::to_sys
+_NODISCARD _STD chrono::system_clock::time_point file_clock::to_sys(const time_point _Time) noexcept {
+    return _STD chrono::system_clock::time_point{
+        _STD chrono::floor<_STD chrono::system_clock::duration>(_Time.time_since_epoch())};
+}
+
 // FUNCTION file_status::file_status
 file_status::file_status() noexcept {
     _Init();
-    _Refresh();
 }
 
 file_status::file_status(const path& _Path) noexcept {
     _Init();
-    _Mypath = _Path;
-    _Refresh();
+    _Mypath = _Path; // nothing is fetched until some field is requested
 }
 
 file_status::file_status(const path& _Target, const file_attributes _Attr, const file_permissions _Perms,
-    const file_type _Type) noexcept : _Mypath(_Target), _Myattr(_Attr), _Myperms(_Perms), _Mytype(_Type) {}
+    const file_type _Type) noexcept
+    : _Mypath(_Target), _Myattr(_Attr), _Myperms(_Perms), _Mytype(_Type), _Myknown(_File_status_fields::_All) {}
 
 // FUNCTION file_status::_Init
 void file_status::_Init() noexcept {
@@ -34,102 +96,170 @@ void file_status::_Init() noexcept {
     _Myattr  = file_attributes::none;
     _Myperms = file_permissions::none;
     _Mytype  = file_type::none;
+    _Myknown = _File_status_fields::_None;
 }
 
 // FUNCTION file_status::_Refresh
-void file_status::_Refresh() noexcept {
-    _Update_attribute(file_attributes{GetFileAttributesW(_Mypath.generic_wstring().c_str())});
-
-    // If _Mypath not found, GetFileAttributeW() will return INVALID_FILE_ATTRIBUTES.
-    // Don't use GetLastError() to check if _Mypath exists, because some functions
-    // will return ERROR_PATH_NOT_FOUND and others ERROR_FILE_NOT_FOUND when they cannot find target.
-    if (_Myattr == file_attributes::unknown) { // file_attributes::unknown means, that target not found
-        _Update_attribute(file_attributes::none);
-        _Update_permissions(file_permissions::none);
-        _Update_type(file_type::not_found);
-        return; // don't check anything else
+void file_status::_Refresh(const _File_status_fields _Fields) const noexcept {
+    const _File_status_fields _Missing{_Fields ^ (_Fields & _Myknown)};
+    if (_Missing == _File_status_fields::_None) { // everything is known, nothing to do
+        return;
     }
 
-    if ((_Myattr & file_attributes::readonly) == file_attributes::readonly) { // read-only
-        _Update_permissions(file_permissions::readonly);
-    } else { // full access
-        _Update_permissions(file_permissions::all);
-    }
-
-    // Theoretically we could use FindFirstFile() with WIN32_FIND_DATAW, because it's a bit faster,
-    // but when we use DeviceIoControl(), we are on lower level, where we can define buffer size etc.
-    // It's safer as well, because if _Mypath is bad, there're only execptions from us.
-
-    if ((_Myattr & file_attributes::reparse_point) == file_attributes::reparse_point) {
-        // In some cases _Refresh() may using more bytes than defaule maximum (16384 bytes).
-        // To avoid C6262 warning and potential threat, buffor size is set to 16284 bytes.
-        // It shouldn't change result and it's safer. If your /analyse:stacksize is set to larger value,
-        // you can change buffer size.
-        unsigned char _Buff[MAXIMUM_REPARSE_DATA_BUFFER_SIZE - 100] = {};
-        reparse_data_buffer& _Reparse_buff                          = reinterpret_cast<reparse_data_buffer&>(_Buff);
-        unsigned long _Bytes                                        = 0; // returned bytes from DeviceIoControl()
-        const HANDLE _Handle                                        = CreateFileW(_Mypath.generic_wstring().c_str(),
-            static_cast<unsigned long>(file_access::all), static_cast<unsigned long>(file_share::read),
-            nullptr, static_cast<unsigned long>(file_disposition::only_if_exists), static_cast<unsigned long>(
-                file_flags::backup_semantics | file_flags::open_reparse_point), nullptr);
-        _FILESYSTEM_VERIFY_HANDLE(_Handle);
-        if (!DeviceIoControl(_Handle, FSCTL_GET_REPARSE_POINT, nullptr, 0,
-            &_Reparse_buff, sizeof(_Buff), &_Bytes, nullptr)) { // failed to get informations
-            CloseHandle(_Handle); // should be closed even if function will throw an exception
-            _Throw_fs_error("failed to get informations", error_type::runtime_error, "_Refresh");
+#if _HAS_WINDOWS
+    if (!_Has_fields(_Myknown, _File_status_fields::_Attribute)) {
+        // If _Mypath not found, GetFileAttributeW() will return INVALID_FILE_ATTRIBUTES.
+        // Don't use GetLastError() to check if _Mypath exists, because some functions
+        // will return ERROR_PATH_NOT_FOUND and others ERROR_FILE_NOT_FOUND when they cannot find target.
+        const file_attributes _Attr{GetFileAttributesW(_Mypath.c_str())};
+        if (_Attr == file_attributes::unknown) { // file_attributes::unknown means, that target not found
+            _Set_not_found();
+            return; // don't check anything else
         }
-        
-        CloseHandle(_Handle);
-        if (_Reparse_buff._Reparse_tag == static_cast<unsigned long>(file_reparse_tag::mount_point)) {
-            _Update_type(file_type::junction);
-            return;
+
+        // existence and permissions come from the same call
+        _Update_attribute(_Attr);
+        _Update_permissions((_Attr & file_attributes::readonly) == file_attributes::readonly
+            ? file_permissions::readonly : file_permissions::all);
+        _Myknown = _Myknown | _File_status_fields::_Existence | _File_status_fields::_Attribute
+                 | _File_status_fields::_Permissions;
+    }
+
+    if (_Has_fields(_Missing, _File_status_fields::_Type)) {
+        // only reparse points need the second call, the others are recognized by their attributes
+        file_type _Type{file_type::none};
+        if ((_Myattr & file_attributes::reparse_point) == file_attributes::reparse_point) {
+            const unsigned long _Tag{_Reparse_tag(_Mypath)};
+            if (_Tag == static_cast<unsigned long>(file_reparse_tag::mount_point)) {
+                _Type = file_type::junction;
+            } else if (_Tag == static_cast<unsigned long>(file_reparse_tag::symlink)) {
+                _Type = file_type::symlink;
+            }
+
+            // all others are file or directory types
         }
 
-        if (_Reparse_buff._Reparse_tag == static_cast<unsigned long>(file_reparse_tag::symlink)) {
-            _Update_type(file_type::symlink);
-            return;
+        if (_Type == file_type::none) {
+            _Type = (_Myattr & file_attributes::directory) == file_attributes::directory
+                ? file_type::directory : file_type::regular;
         }
 
-        // all others are file or directory types
+        _Update_type(_Type);
+        _Myknown = _Myknown | _File_status_fields::_Type;
+    }
+#else // ^^^ _HAS_WINDOWS ^^^ / vvv !_HAS_WINDOWS vvv
+    // ask only for the needed fields, an empty mask checks existence only
+    unsigned int _Mask{0};
+    if (_Has_fields(_Missing, _File_status_fields::_Type)) {
+        _Mask |= STATX_TYPE;
+    }
+
+    if (_Has_fields(_Missing, _File_status_fields::_Permissions)) {
+        _Mask |= STATX_MODE;
+    }
+
+    if (_Has_fields(_Missing, _File_status_fields::_Attribute)) {
+        _Mask |= STATX_TYPE | STATX_MODE;
+    }
+
+    struct statx _Stat;
+    if (::statx(AT_FDCWD, _Mypath.c_str(), AT_SYMLINK_NOFOLLOW | AT_NO_AUTOMOUNT, _Mask, &_Stat) != 0) {
+        _Set_not_found();
+        return; // don't check anything else
+    }
+
+    // the kernel may return more than was asked for, keep everything that came for free
+    _Myknown = _Myknown | _File_status_fields::_Existence;
+    if ((_Stat.stx_mask & STATX_TYPE) != 0) {
+        _Update_type(_File_type_from_mode(_Stat.stx_mode));
+        _Myknown = _Myknown | _File_status_fields::_Type;
+    }
+
+    if ((_Stat.stx_mask & STATX_MODE) == 0) { // neither permissions nor attributes are available
+        return;
     }
 
-    if ((_Myattr & file_attributes::directory) == file_attributes::directory) {
-        _Update_type(file_type::directory);
-    } else {
-        _Update_type(file_type::regular);
+    const bool _Readonly{(_Stat.stx_mode & (S_IWUSR | S_IWGRP | S_IWOTH)) == 0};
+    _Update_permissions(_Readonly ? file_permissions::readonly : file_permissions::all);
+    _Myknown = _Myknown | _File_status_fields::_Permissions;
+
+    const file_type _Type{_File_type_from_mode(_Stat.stx_mode)};
+    if (_Type == file_type::symlink && !_Has_fields(_Missing, _File_status_fields::_Attribute)) {
+        return; // attributes of symbolic link need one more call, do it only if they were requested
     }
+
+    // Linux has no attributes, build them from the mode, so that they mean the same as on Windows
+    file_attributes _Attr{file_attributes::none};
+    if (_Type == file_type::directory) {
+        _Attr = file_attributes::directory;
+    } else if (_Type == file_type::symlink) { // symbolic link to directory is a directory as well
+        struct stat _Target;
+        _Attr = file_attributes::reparse_point;
+        if (::stat(_Mypath.c_str(), &_Target) == 0 && S_ISDIR(_Target.st_mode)) {
+            _Attr = _Attr | file_attributes::directory;
+        }
+    }
+
+    if (_Readonly) {
+        _Attr = _Attr | file_attributes::readonly;
+    }
+
+    _Update_attribute(_Attr == file_attributes::none ? file_attributes::normal : _Attr);
+    _Myknown = _Myknown | _File_status_fields::_Attribute;
+#endif // _HAS_WINDOWS
+}
+
+// FUNCTION file_status::_Set_not_found
+void file_status::_Set_not_found() const noexcept {
+    _Update_attribute(file_attributes::none);
+    _Update_permissions(file_permissions::none);
+    _Update_type(file_type::not_found);
+    _Myknown = _File_status_fields::_All;
 }
 
 // FUNCTION file_status::_Update_attribute
-void file_status::_Update_attribute(const file_attributes _Newattrib) noexcept {
+void file_status::_Update_attribute(const file_attributes _Newattrib) const noexcept {
     _Myattr = _Newattrib;
 }
 
 // FUNCTION file_status::_Update_permissions
-void file_status::_Update_permissions(const file_permissions _Newperms) noexcept {
+void file_status::_Update_permissions(const file_permissions _Newperms) const noexcept {
     _Myperms = _Newperms;
 }
 
 // FUNCTION file_status::_Update_type
-void file_status::_Update_type(const file_type _Newtype) noexcept {
+void file_status::_Update_type(const file_type _Newtype) const noexcept {
     _Mytype = _Newtype;
 }
 
 // FUNCTION file_status::attribute
 _NODISCARD const file_attributes file_status::attribute() const noexcept {
+    _Refresh(_File_status_fields::_Attribute);
     return _Myattr;
 }
 
 // FUNCTION file_status::permissions
 _NODISCARD const file_permissions file_status::permissions() const noexcept {
+    _Refresh(_File_status_fields::_Permissions);
     return _Myperms;
 }
 
 // FUNCTION file_status::type
 _NODISCARD const file_type file_status::type() const noexcept {
+    _Refresh(_File_status_fields::_Type);
     return _Mytype;
 }
 
+// FUNCTION file_status::_Exists
+_NODISCARD bool file_status::_Exists() const noexcept {
+    _Refresh(_File_status_fields::_Existence);
+    if (!_Has_fields(_Myknown, _File_status_fields::_Type)) { // found, but the type wasn't needed so far
+        return true;
+    }
+
+    return _Mytype != file_type::none && _Mytype != file_type::not_found;
+}
+
 // FUNCTION directory_data::directory_data
 directory_data::directory_data() noexcept {
     _Init();
@@ -142,6 +272,38 @@ directory_data::directory_data(const path& _Path) noexcept {
     _Refresh(); // get the latest informaions
 }
 
+// FUNCTION directory_data::_Add
+void directory_data::_Add(const path& _Name, const file_type _Type) {
+    if (_Type == file_type::none || _Type == file_type::not_found) { // removed while reading the directory
+        return;
+    }
+
+    _Myname[5].push_back(_Name); // each type
+    ++_Mycount[5];
+    switch (_Type) {
+    case file_type::directory:
+        _Myname[0].push_back(_Name);
+        ++_Mycount[0];
+        return;
+    case file_type::regular:
+        _Myname[3].push_back(_Name);
+        ++_Mycount[3];
+        return;
+    case file_type::symlink:
+        _Myname[4].push_back(_Name);
+        ++_Mycount[4];
+        return;
+    case file_type::junction:
+        _Myname[1].push_back(_Name);
+        ++_Mycount[1];
+        return;
+    default: // other
+        _Myname[2].push_back(_Name);
+        ++_Mycount[2];
+        return;
+    }
+}
+
 // FUNCTION directory_data::_Init
 void directory_data::_Init() noexcept {
     _Mypath = path();
@@ -156,56 +318,10 @@ void directory_data::_Refresh() noexcept {
     _FILESYSTEM_VERIFY(exists(_Mypath), "directory not found", error_type::runtime_error);
     _FILESYSTEM_VERIFY(_Is_directory(_Mypath), "expected a directory", error_type::runtime_error);
 
-    WIN32_FIND_DATAW _Data = WIN32_FIND_DATAW();
-    const HANDLE _Handle   = FindFirstFileExW(path(_Mypath + LR"(\*)").generic_wstring().c_str(),
-        FindExInfoBasic, &_Data, FindExSearchNameMatch, nullptr, 0);
-    _FILESYSTEM_VERIFY_HANDLE(_Handle);
-
-    vector<path> _All;
-    do { // get all types, they will be separated later
-        _All.push_back(static_cast<const wchar_t*>(_Data.cFileName));
-    } while (FindNextFileW(_Handle, &_Data));
-
-    FindClose(_Handle);
+    // types come from the directory entries, so no entry needs its own system call
     _Reset(); // clear everything
-    if (_All.empty()) { // nothing to do if directory is empty
-        return;
-    }
-
-    path _Precise; // creates full path to _All[_Idx]
-    for (const auto& _Elem : _All) {
-        if (_Elem != "." && _Elem != "..") { // skip dots
-            _Precise = _Mypath + LR"(\)" + _Elem;
-            file_status _Status(_Precise);
-            _Myname[5].push_back(_Elem); // each type
-            ++_Mycount[5];
-            switch (_Status.type()) {
-            case file_type::none: // never happens
-                continue;
-            case file_type::not_found: // never happens
-                continue;
-            case file_type::directory:
-                _Myname[0].push_back(_Elem);
-                ++_Mycount[0];
-                continue;
-            case file_type::regular:
-                _Myname[3].push_back(_Elem);
-                ++_Mycount[3];
-                continue;
-            case file_type::symlink:
-                _Myname[4].push_back(_Elem);
-                ++_Mycount[4];
-                continue;
-            case file_type::junction:
-                _Myname[1].push_back(_Elem);
-                ++_Mycount[1];
-                continue;
-            default: // other
-                _Myname[2].push_back(_Elem);
-                ++_Mycount[2];
-                continue;
-            }
-        }
+    for (const directory_entry& _Entry : directory_iterator(_Mypath)) {
+        _Add(_Entry.name, _Entry.type);
     }
 }
 
@@ -278,11 +394,31 @@ _NODISCARD const uintmax_t directory_data::total_count() const noexcept {
     return _Mycount[5];
 }
 
+#if !_HAS_WINDOWS
+// FUNCTION _Set_readonly
+_NODISCARD bool _Set_readonly(const path& _Target, const bool _Readonly) noexcept {
+    struct stat _Stat;
+    if (::stat(_Target.c_str(), &_Stat) != 0) {
+        return false;
+    }
+
+    constexpr mode_t _Write_bits{S_IWUSR | S_IWGRP | S_IWOTH};
+    const mode_t _Mode{_Readonly ? (_Stat.st_mode & ~_Write_bits) : (_Stat.st_mode | S_IWUSR)};
+    return ::chmod(_Target.c_str(), _Mode & 07777) == 0;
+}
+#endif // !_HAS_WINDOWS
+
 // FUNCTION change_attributes
 _NODISCARD bool change_attributes(const path& _Target, const file_attributes _Newattr) {
     _FILESYSTEM_VERIFY(exists(_Target), "target not found", error_type::runtime_error);
-    _FILESYSTEM_VERIFY(SetFileAttributesW(_Target.generic_wstring().c_str(),
+#if _HAS_WINDOWS
+    _FILESYSTEM_VERIFY(SetFileAttributesW(_Target.c_str(),
         static_cast<unsigned long>(_Newattr)), "failed to change attributes", error_type::runtime_error);
+#else // ^^^ _HAS_WINDOWS ^^^ / vvv !_HAS_WINDOWS vvv
+    // only file_attributes::readonly can be represented on Linux, others are ignored
+    _FILESYSTEM_VERIFY(_Set_readonly(_Target, (_Newattr & file_attributes::readonly) == file_attributes::readonly),
+        "failed to change attributes", error_type::runtime_error);
+#endif // _HAS_WINDOWS
     return true;
 }
 
@@ -302,8 +438,13 @@ _NODISCARD bool change_permissions(const path& _Target, const file_permissions _
         const_cast<file_attributes&>(_Attr) ^= _Status.attribute();
     }
 
-    _FILESYSTEM_VERIFY(SetFileAttributesW(_Target.generic_wstring().c_str(), static_cast<unsigned long>(_Attr)),
+#if _HAS_WINDOWS
+    _FILESYSTEM_VERIFY(SetFileAttributesW(_Target.c_str(), static_cast<unsigned long>(_Attr)),
+        "failed to set new permissions", error_type::runtime_error);
+#else // ^^^ _HAS_WINDOWS ^^^ / vvv !_HAS_WINDOWS vvv
+    _FILESYSTEM_VERIFY(_Set_readonly(_Target, (_Attr & file_attributes::readonly) == file_attributes::readonly),
         "failed to set new permissions", error_type::runtime_error);
+#endif // _HAS_WINDOWS
     return true;
 }
 
@@ -312,129 +453,172 @@ _NODISCARD bool change_permissions(const path& _Target, const file_permissions _
 }
 
 // FUNCTION creation_time
-_NODISCARD file_time creation_time(const path& _Target) {
-    _FILESYSTEM_VERIFY(exists(_Target), "target not found", error_type::runtime_error);
-    const HANDLE _Handle{CreateFileW(_Target.generic_wstring().c_str(),
-        static_cast<unsigned long>(file_access::readonly), static_cast<unsigned long>(file_share::read),
-        nullptr, static_cast<unsigned long>(file_disposition::only_if_exists), static_cast<unsigned long>(
-            file_flags::backup_semantics | file_flags::open_reparse_point), nullptr)};
-    _FILESYSTEM_VERIFY_HANDLE(_Handle);
-
-    FILETIME _File_time;
-    if (!GetFileTime(_Handle, &_File_time, nullptr, nullptr)) { // failed to get file time
-        CloseHandle(_Handle); // should be closed even if function will throw an exception
-        _Throw_fs_error("failed to get file time", error_type::runtime_error, "creation_time");
-    }
-
-    CloseHandle(_Handle);
-
-    // convert file time to system time and then to user time zone
-    SYSTEMTIME _Sys_gen_time; // general system time
-    SYSTEMTIME _Sys_exact_time; // system time in user region
-    _FILESYSTEM_VERIFY(FileTimeToSystemTime(&_File_time, &_Sys_gen_time),
-        "failed to convert file time to system time", error_type::runtime_error);
-    _FILESYSTEM_VERIFY(SystemTimeToTzSpecificLocalTimeEx(nullptr, &_Sys_gen_time, &_Sys_exact_time),
-        "failed to convert general system time to exact system time", error_type::runtime_error);
-    return {_Sys_exact_time.wYear, _Sys_exact_time.wMonth, _Sys_exact_time.wDay,
-        _Sys_exact_time.wHour, _Sys_exact_time.wMinute, _Sys_exact_time.wSecond};
+_NODISCARD file_clock::time_point creation_time(const path& _Target) {
+    const file_info _Info{info(_Target)};
+    _FILESYSTEM_VERIFY(_Info.has_creation_time, "failed to get file time", error_type::runtime_error);
+    return _Info.creation_time;
 }
 
+#if _HAS_WINDOWS
 #pragma warning(push, 1)
 #pragma warning(disable : 4067) // C4067: token after preprocessor directive (?)
+#endif // _HAS_WINDOWS
 // FUNCTION equivalent
 _NODISCARD bool equivalent(const path& _Left, const path& _Right) {
-    _FILESYSTEM_VERIFY(exists(_Left) && exists(_Right), "target not found", error_type::runtime_error);
-
-    file_id _Left_id{file_id()};
-    {
-        const HANDLE _Handle{CreateFileW(_Left.generic_wstring().c_str(),
-            static_cast<unsigned long>(file_access::readonly), static_cast<unsigned long>(
-            file_share::read), nullptr, static_cast<unsigned long>(file_disposition::only_if_exists),
-            static_cast<unsigned long>(file_flags::backup_semantics), nullptr)}; // don't use file_flags::open_reparse_point
-        _FILESYSTEM_VERIFY_HANDLE(_Handle);
-
-        if (!GetFileInformationByHandleEx(_Handle, FileIdInfo, &_Left_id,
-            sizeof(_Left_id))) { // failed to get informations
-            CloseHandle(_Handle); // should be closed even if function will throw an exception
-            _Throw_fs_error("failed to get informations", error_type::runtime_error, "equivalent");
-        }
-
-        CloseHandle(_Handle);
-    }
-
-    file_id _Right_id{file_id()};
-    {
-        const HANDLE _Handle{CreateFileW(_Right.generic_wstring().c_str(),
-            static_cast<unsigned long>(file_access::readonly), static_cast<unsigned long>(
-            file_share::read), nullptr, static_cast<unsigned long>(file_disposition::only_if_exists),
-            static_cast<unsigned long>(file_flags::backup_semantics), nullptr)}; // don't use file_flags::open_reparse_point
-        _FILESYSTEM_VERIFY_HANDLE(_Handle);
-
-        if (!GetFileInformationByHandleEx(_Handle, FileIdInfo, &_Right_id,
-            sizeof(_Right_id))) { // failed to get informations
-            CloseHandle(_Handle); // should be closed even if function will throw an exception
-            _Throw_fs_error("failed to get informations", error_type::runtime_error, "equivalent");
-        }
-        
-        CloseHandle(_Handle);
-    }
-
+    // links should be resolved
+    const file_id _Left_id{info(_Left, true).id};
+    const file_id _Right_id{info(_Right, true).id};
 #if __has_builtin(__builtin_memcmp)
     return __builtin_memcmp(&_Left_id, &_Right_id, sizeof(file_id)) == 0;
 #else // ^^^ __has_builtin(__builtin_memcmp) ^^^ / vvv !__has_builtin(__builtin_memcmp) vvv
     return _CSTD memcmp(&_Left_id, &_Right_id, sizeof(file_id)) == 0;
 #endif // __has_builtin(__builtin_memcmp)
 }
+#if _HAS_WINDOWS
 #pragma warning(default : 4067)
 #pragma warning(pop)
+#endif // _HAS_WINDOWS
 
 // FUNCTION exists
-_NODISCARD bool exists(const file_status _Status) noexcept {
-    return _Status.type() != file_type::none && _Status.type() != file_type::not_found;
+_NODISCARD bool exists(const file_status& _Status) noexcept {
+    return _Status._Exists();
 }
 
 _NODISCARD bool exists(const path& _Target) noexcept {
-    return exists(file_status(_Target));
+    return file_status(_Target)._Exists();
 }
 
 // FUNCTION file_size
-_NODISCARD size_t file_size(const path& _Target) {
-    _FILESYSTEM_VERIFY(exists(_Target), "file not found", error_type::runtime_error);
-    _FILESYSTEM_VERIFY(!_Is_directory(_Target), "expected a file", error_type::runtime_error);
-
-    const HANDLE _Handle{CreateFileW(_Target.generic_wstring().c_str(), static_cast<unsigned long>(file_access::readonly),
-        static_cast<unsigned long>(file_share::read), nullptr, static_cast<unsigned long>(file_disposition::only_if_exists),
-        static_cast<unsigned long>(file_flags::open_reparse_point), nullptr)};
-    _FILESYSTEM_VERIFY_HANDLE(_Handle);
-
-    const size_t _Size{static_cast<size_t>(GetFileSize(_Handle, nullptr))};
-    CloseHandle(_Handle);
-    return _Size;
+_NODISCARD uintmax_t file_size(const path& _Target) {
+    const file_info _Info{info(_Target)};
+    _FILESYSTEM_VERIFY(_Info.type != file_type::directory && _Info.type != file_type::junction,
+        "expected a file", error_type::runtime_error);
+    return _Info.size;
 }
 
 // FUNCTION hard_link_count
 _NODISCARD uintmax_t hard_link_count(const path& _Target, const file_flags _Flags) { // counts hard links to _Target
-    const HANDLE _Handle{CreateFileW(_Target.generic_wstring().c_str(),
-        static_cast<unsigned long>(file_access::readonly), static_cast<unsigned long>(file_share::read), nullptr,
-        static_cast<unsigned long>(file_disposition::only_if_exists), static_cast<unsigned long>(_Flags), nullptr)};
-    _FILESYSTEM_VERIFY_HANDLE(_Handle);
+    // file_flags::open_reparse_point means, that links aren't followed
+    return info(_Target, (_Flags & file_flags::open_reparse_point) != file_flags::open_reparse_point).hard_link_count;
+}
+
+_NODISCARD uintmax_t hard_link_count(const path& _Target) {
+    return hard_link_count(_Target, file_flags::backup_semantics | file_flags::open_reparse_point);
+}
+
+// FUNCTION info
+_NODISCARD file_info info(const path& _Target, const bool _Follow_links) {
+    file_info _Result;
+    _FILESYSTEM_VERIFY(_Try_info(_Target, _Follow_links, _Result), "target not found", error_type::runtime_error);
+    return _Result;
+}
+
+_NODISCARD file_info info(const path& _Target) {
+    return info(_Target, false);
+}
+
+#if _HAS_WINDOWS
+// FUNCTION _Handle_info
+_NODISCARD bool _Handle_info(const HANDLE _Handle, file_info& _Result) noexcept {
+    BY_HANDLE_FILE_INFORMATION _Data;
+    FILE_STANDARD_INFO _Standard;
+    FILE_ATTRIBUTE_TAG_INFO _Tag{FILE_ATTRIBUTE_TAG_INFO()};
+    bool _Succeeded{GetFileInformationByHandle(_Handle, &_Data) != 0
+        && GetFileInformationByHandleEx(_Handle, FileIdInfo, &_Result.id, sizeof(_Result.id)) != 0
+        && GetFileInformationByHandleEx(_Handle, FileStandardInfo, &_Standard, sizeof(_Standard)) != 0};
+    if (_Succeeded && (_Data.dwFileAttributes & FILE_ATTRIBUTE_REPARSE_POINT) != 0) { // symlink or junction
+        _Succeeded = GetFileInformationByHandleEx(_Handle, FileAttributeTagInfo, &_Tag, sizeof(_Tag)) != 0;
+    }
+
+    if (!_Succeeded) {
+        return false;
+    }
+
+    if (_Tag.ReparseTag == static_cast<unsigned long>(file_reparse_tag::mount_point)) {
+        _Result.type = file_type::junction;
+    } else if (_Tag.ReparseTag == static_cast<unsigned long>(file_reparse_tag::symlink)) {
+        _Result.type = file_type::symlink;
+    } else { // all others are file or directory types
+        _Result.type = (_Data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) != 0
+            ? file_type::directory : file_type::regular;
+    }
+
+    _Result.size              = (static_cast<uintmax_t>(_Data.nFileSizeHigh) << 32) | _Data.nFileSizeLow;
+    _Result.allocation_size   = static_cast<uintmax_t>(_Standard.AllocationSize.QuadPart);
+    _Result.hard_link_count   = static_cast<uintmax_t>(_Data.nNumberOfLinks);
+    _Result.creation_time     = _File_clock_from_filetime(_Data.ftCreationTime);
+    _Result.last_access_time  = _File_clock_from_filetime(_Data.ftLastAccessTime);
+    _Result.last_write_time   = _File_clock_from_filetime(_Data.ftLastWriteTime);
+    _Result.has_creation_time = true;
+    return true;
+}
+#endif // _HAS_WINDOWS
+
+// FUNCTION _Try_info
+_NODISCARD bool _Try_info(const path& _Target, const bool _Follow_links, file_info& _Result) {
+    _Result = file_info{};
+#if _HAS_WINDOWS
+    // FILE_READ_ATTRIBUTES is enough for metadata, it doesn't need the right to read the content
+    const file_flags _Flags{_Follow_links ? file_flags::backup_semantics
+        : file_flags::backup_semantics | file_flags::open_reparse_point};
+    const HANDLE _Handle{CreateFileW(_Target.c_str(), FILE_READ_ATTRIBUTES, static_cast<unsigned long>(file_share::all),
+        nullptr, static_cast<unsigned long>(file_disposition::only_if_exists), static_cast<unsigned long>(_Flags), nullptr)};
+    if (_Handle == INVALID_HANDLE_VALUE) {
+        const unsigned long _Error{GetLastError()};
+        if (_Error == ERROR_FILE_NOT_FOUND || _Error == ERROR_PATH_NOT_FOUND) {
+            return false;
+        }
 
-    FILE_STANDARD_INFO _Info{FILE_STANDARD_INFO()};
-    if (!GetFileInformationByHandleEx(_Handle, FileStandardInfo, &_Info, sizeof(_Info))) {
-        CloseHandle(_Handle); // should be closed even if function will throw an exception
-        _Throw_fs_error("failed to get informations", error_type::runtime_error, "hard_link_count");
+        _Throw_fs_error("failed to get handle", error_type::runtime_error, "info");
     }
-    
+
+    // everything comes from the same handle, the path is resolved only once
+    const bool _Succeeded{_Handle_info(_Handle, _Result)};
     CloseHandle(_Handle);
-    return static_cast<uintmax_t>(_Info.NumberOfLinks);
+    _FILESYSTEM_VERIFY(_Succeeded, "failed to get informations", error_type::runtime_error);
+    return true;
+#else // ^^^ _HAS_WINDOWS ^^^ / vvv !_HAS_WINDOWS vvv
+    return _Try_info_at(AT_FDCWD, _Target.c_str(), _Follow_links, _Result);
+#endif // _HAS_WINDOWS
 }
 
-_NODISCARD uintmax_t hard_link_count(const path& _Target) {
-    return hard_link_count(_Target, file_flags::backup_semantics | file_flags::open_reparse_point);
+#if !_HAS_WINDOWS
+// FUNCTION _Try_info_at
+_NODISCARD bool _Try_info_at(const int _Dirfd, const char* const _Name, const bool _Follow_links, file_info& _Result) {
+    _Result = file_info{};
+    struct statx _Stat;
+    const int _Empty{_Name[0] == '\0' && _Dirfd != AT_FDCWD ? AT_EMPTY_PATH : 0}; // the open file itself
+    if (::statx(_Dirfd, _Name, AT_NO_AUTOMOUNT | _Empty | (_Follow_links ? 0 : AT_SYMLINK_NOFOLLOW),
+        STATX_BASIC_STATS | STATX_BTIME, &_Stat) != 0) {
+        if (errno == ENOENT || errno == ENOTDIR) {
+            return false;
+        }
+
+        _Throw_fs_error("failed to get informations", error_type::runtime_error, "info");
+    }
+
+    // device and inode identify the file, store them the same way as FILE_ID_INFO does
+    const uint64_t _Inode{_Stat.stx_ino};
+    _Result.id._Volume_serial_number = (static_cast<uint64_t>(_Stat.stx_dev_major) << 32) | _Stat.stx_dev_minor;
+    _CSTD memcpy(_Result.id._Id, &_Inode, sizeof(_Inode));
+
+    _Result.type              = _File_type_from_mode(_Stat.stx_mode);
+    _Result.size              = static_cast<uintmax_t>(_Stat.stx_size);
+    _Result.allocation_size   = static_cast<uintmax_t>(_Stat.stx_blocks) * 512; // st_blocks is always in 512 B units
+    _Result.hard_link_count   = static_cast<uintmax_t>(_Stat.stx_nlink);
+    _Result.last_access_time  = _File_clock_from_timespec(_Stat.stx_atime.tv_sec, _Stat.stx_atime.tv_nsec);
+    _Result.last_write_time   = _File_clock_from_timespec(_Stat.stx_mtime.tv_sec, _Stat.stx_mtime.tv_nsec);
+    _Result.has_creation_time = (_Stat.stx_mask & STATX_BTIME) != 0;
+    if (_Result.has_creation_time) {
+        _Result.creation_time = _File_clock_from_timespec(_Stat.stx_btime.tv_sec, _Stat.stx_btime.tv_nsec);
+    }
+
+    return true;
 }
+#endif // !_HAS_WINDOWS
 
 // FUNCTION _Is_directory
-_NODISCARD bool _Is_directory(const file_status _Status) noexcept {
+_NODISCARD bool _Is_directory(const file_status& _Status) noexcept {
     return (_Status.attribute() & file_attributes::directory) == file_attributes::directory;
 }
 
@@ -443,7 +627,7 @@ _NODISCARD bool _Is_directory(const path& _Target) noexcept {
 }
 
 // FUNCTION is_directory
-_NODISCARD bool is_directory(const file_status _Status) noexcept {
+_NODISCARD bool is_directory(const file_status& _Status) noexcept {
     return _Status.type() == file_type::directory;
 }
 
@@ -458,7 +642,7 @@ _NODISCARD bool is_empty(const path& _Target) {
 }
 
 // FUNCTION is_junction
-_NODISCARD bool is_junction(const file_status _Status) noexcept {
+_NODISCARD bool is_junction(const file_status& _Status) noexcept {
     return _Status.type() == file_type::junction;
 }
 
@@ -467,7 +651,7 @@ _NODISCARD bool is_junction(const path& _Target) noexcept {
 }
 
 // FUNCTION is_other
-_NODISCARD bool is_other(const file_status _Status) noexcept {
+_NODISCARD bool is_other(const file_status& _Status) noexcept {
     switch (_Status.type()) {
     case file_type::none:
     case file_type::not_found:
@@ -487,7 +671,7 @@ _NODISCARD bool is_other(const path& _Target) noexcept {
 }
  
 // FUNCTION is_regular_file
-_NODISCARD bool is_regular_file(const file_status _Status) noexcept { 
+_NODISCARD bool is_regular_file(const file_status& _Status) noexcept { 
     return _Status.type() == file_type::regular;
 }
 
@@ -496,7 +680,7 @@ _NODISCARD bool is_regular_file(const path& _Target) noexcept {
 }
 
 // FUNCTION is_symlink
-_NODISCARD bool is_symlink(const file_status _Status) noexcept {
+_NODISCARD bool is_symlink(const file_status& _Status) noexcept {
     return _Status.type() == file_type::symlink;
 }
 
@@ -517,63 +701,16 @@ _NODISCARD file_status junction_status(const path& _Target) noexcept {
 }
 
 // FUNCTION last_access_time
-_NODISCARD file_time last_access_time(const path& _Target) {
-    _FILESYSTEM_VERIFY(exists(_Target), "target not found", error_type::runtime_error);
-
-    const HANDLE _Handle{CreateFileW(_Target.generic_wstring().c_str(),
-        static_cast<unsigned long>(file_access::readonly), static_cast<unsigned long>(file_share::read),
-        nullptr, static_cast<unsigned long>(file_disposition::only_if_exists), static_cast<unsigned long>(
-            file_flags::backup_semantics | file_flags::open_reparse_point), nullptr)};
-    _FILESYSTEM_VERIFY_HANDLE(_Handle);
-
-    FILETIME _File_time;
-    if (!GetFileTime(_Handle, nullptr, &_File_time, nullptr)) { // failed to get file time
-        CloseHandle(_Handle); // should be closed even if function will throw an exception
-        _Throw_fs_error("failed to get file time", error_type::runtime_error, "last_access_time");
-    }
-
-    CloseHandle(_Handle);
-
-    // convert file time to system time and then to user time zone
-    SYSTEMTIME _Sys_gen_time; // general system time
-    SYSTEMTIME _Sys_exact_time; // system time in user region
-    _FILESYSTEM_VERIFY(FileTimeToSystemTime(&_File_time, &_Sys_gen_time),
-        "failed to convert file time to system time", error_type::runtime_error);
-    _FILESYSTEM_VERIFY(SystemTimeToTzSpecificLocalTimeEx(nullptr, &_Sys_gen_time, &_Sys_exact_time),
-        "failed to convert general system time to exact system time", error_type::runtime_error);
-    return {_Sys_exact_time.wYear, _Sys_exact_time.wMonth, _Sys_exact_time.wDay,
-        _Sys_exact_time.wHour, _Sys_exact_time.wMinute, _Sys_exact_time.wSecond};
+_NODISCARD file_clock::time_point last_access_time(const path& _Target) {
+    return info(_Target).last_access_time;
 }
 
 // FUNCTION last_write_time
-_NODISCARD file_time last_write_time(const path& _Target) {
-    _FILESYSTEM_VERIFY(exists(_Target), "target not found", error_type::runtime_error);
-
-    const HANDLE _Handle{CreateFileW(_Target.generic_wstring().c_str(),
-        static_cast<unsigned long>(file_access::readonly), static_cast<unsigned long>(file_share::read),
-        nullptr, static_cast<unsigned long>(file_disposition::only_if_exists), static_cast<unsigned long>(
-            file_flags::backup_semantics | file_flags::open_reparse_point), nullptr)};
-    _FILESYSTEM_VERIFY_HANDLE(_Handle);
-
-    FILETIME _File_time;
-    if (!GetFileTime(_Handle, nullptr, nullptr, &_File_time)) { // failed to get file time
-        CloseHandle(_Handle); // should be closed even if function will throw an exception
-        _Throw_fs_error("failed to get file time", error_type::runtime_error, "last_write_time");
-    }
-
-    CloseHandle(_Handle);
-
-    // convert file time to system time and then to user time zone
-    SYSTEMTIME _Sys_gen_time; // general system time
-    SYSTEMTIME _Sys_exact_time; // system time in user region
-    _FILESYSTEM_VERIFY(FileTimeToSystemTime(&_File_time, &_Sys_gen_time),
-        "failed to convert file time to system time", error_type::runtime_error);
-    _FILESYSTEM_VERIFY(SystemTimeToTzSpecificLocalTimeEx(nullptr, &_Sys_gen_time, &_Sys_exact_time),
-        "failed to convert general system time to exact system time", error_type::runtime_error);
-    return {_Sys_exact_time.wYear, _Sys_exact_time.wMonth, _Sys_exact_time.wDay,
-        _Sys_exact_time.wHour, _Sys_exact_time.wMinute, _Sys_exact_time.wSecond};
+_NODISCARD file_clock::time_point last_write_time(const path& _Target) {
+    return info(_Target).last_write_time;
 }
 
+#if _HAS_WINDOWS
 namespace experimental {
     // FUNCTION shortcut_parameters
     _NODISCARD shortcut_data shortcut_parameters(const path& _Target) {
@@ -595,7 +732,7 @@ namespace experimental {
         wstring _Buff = wstring(); // buffer for shortcut icon/target path
         _Buff.resize(_Max_path); // resize before calling GetIconLocation()
         _FILESYSTEM_VERIFY_COM_RESULT(_Link->QueryInterface(IID_IPersistFile, reinterpret_cast<void**>(&_File)), _Link);
-        _FILESYSTEM_VERIFY_COM_RESULT(_File->Load(_Target.generic_wstring().c_str(), STGM_READ), _Link);
+        _FILESYSTEM_VERIFY_COM_RESULT(_File->Load(_Target.c_str(), STGM_READ), _Link);
         _FILESYSTEM_VERIFY_COM_RESULT(_Link->Resolve(nullptr, 0), _Link);
         _FILESYSTEM_VERIFY_COM_RESULT(_Link->GetArguments(_Result.arguments.data(), INFOTIPSIZE), _Link);
         _FILESYSTEM_VERIFY_COM_RESULT(_Link->GetDescription(_Result.description.data(), INFOTIPSIZE), _Link);
@@ -627,30 +764,40 @@ namespace experimental {
 
         IPersistFile* _File{};
         _FILESYSTEM_VERIFY_COM_RESULT(_Link->QueryInterface(IID_IPersistFile, reinterpret_cast<void**>(&_File)), _Link);
-        _FILESYSTEM_VERIFY_COM_RESULT(_File->Load(_Target.generic_wstring().c_str(), STGM_READ), _Link);
+        _FILESYSTEM_VERIFY_COM_RESULT(_File->Load(_Target.c_str(), STGM_READ), _Link);
         _FILESYSTEM_VERIFY_COM_RESULT(_Link->Resolve(nullptr, 0), _Link);
         _FILESYSTEM_VERIFY_COM_RESULT(_Link->SetArguments(_Params->arguments.c_str()), _Link);
         _FILESYSTEM_VERIFY_COM_RESULT(_Link->SetDescription(_Params->description.c_str()), _Link);
         _FILESYSTEM_VERIFY_COM_RESULT(_Link->SetHotkey(_Params->hotkey), _Link);
-        _FILESYSTEM_VERIFY_COM_RESULT(_Link->SetIconLocation(_Params->icon_path.generic_wstring().c_str(), _Params->icon), _Link);
+        _FILESYSTEM_VERIFY_COM_RESULT(_Link->SetIconLocation(_Params->icon_path.c_str(), _Params->icon), _Link);
         _FILESYSTEM_VERIFY_COM_RESULT(_Link->SetIDList(_Params->id_list), _Link);
-        _FILESYSTEM_VERIFY_COM_RESULT(_Link->SetPath(_Params->target_path.generic_wstring().c_str()), _Link);
+        _FILESYSTEM_VERIFY_COM_RESULT(_Link->SetPath(_Params->target_path.c_str()), _Link);
         _FILESYSTEM_VERIFY_COM_RESULT(_Link->SetShowCmd(_Params->show_cmd), _Link);
-        _FILESYSTEM_VERIFY_COM_RESULT(_Link->SetWorkingDirectory(_Params->directory.generic_wstring().c_str()), _Link);
+        _FILESYSTEM_VERIFY_COM_RESULT(_Link->SetWorkingDirectory(_Params->directory.c_str()), _Link);
         _File->Release();
         _Link->Release();
         return true;
     }
 } // experimental
+#endif // _HAS_WINDOWS
 
 // FUNCTION space
 _NODISCARD disk_space space(const path& _Target) {
     disk_space _Result    = disk_space();
+#if _HAS_WINDOWS
     const auto _Available = reinterpret_cast<PULARGE_INTEGER>(&_Result.available);
     const auto _Capacity  = reinterpret_cast<PULARGE_INTEGER>(&_Result.capacity);
     const auto _Free      = reinterpret_cast<PULARGE_INTEGER>(&_Result.free);
-    _FILESYSTEM_VERIFY(GetDiskFreeSpaceExW(_Target.generic_wstring().c_str(), _Available,
+    _FILESYSTEM_VERIFY(GetDiskFreeSpaceExW(_Target.c_str(), _Available,
         _Capacity, _Free), "failed to get informations", error_type::runtime_error);
+#else // ^^^ _HAS_WINDOWS ^^^ / vvv !_HAS_WINDOWS vvv
+    struct statvfs _Stat;
+    _FILESYSTEM_VERIFY(::statvfs(_Target.c_str(), &_Stat) == 0,
+        "failed to get informations", error_type::runtime_error);
+    _Result.available = static_cast<uintmax_t>(_Stat.f_bavail) * _Stat.f_frsize;
+    _Result.capacity  = static_cast<uintmax_t>(_Stat.f_blocks) * _Stat.f_frsize;
+    _Result.free      = static_cast<uintmax_t>(_Stat.f_bfree) * _Stat.f_frsize;
+#endif // _HAS_WINDOWS
     return _Result;
 }
 
@@ -670,8 +817,83 @@ _NODISCARD file_status status(const path& _Target) noexcept {
     return _Status;
 }
 
+// CONSTANT _Statuses_max_chunk
+inline constexpr size_t _Statuses_max_chunk = 256; // the most targets taken by a worker at once
+
+// CONSTANT _Statuses_chunks_per_worker
+inline constexpr size_t _Statuses_chunks_per_worker = 4; // smaller chunks even out slow targets
+
+// CONSTANT _Statuses_threads_per_core
+inline constexpr unsigned int _Statuses_threads_per_core = 4; // workers mostly wait for the device
+
+// FUNCTION _Status_or_error
+void _Status_or_error(const path& _Target, file_info& _Result) noexcept {
+    _TRY_BEGIN
+    if (!_Try_info(_Target, false, _Result)) {
+        _Result      = file_info{};
+        _Result.type = file_type::not_found;
+    }
+    _CATCH_ALL
+    _Result      = file_info{};
+    _Result.type = file_type::none; // status unknown
+    _CATCH_END
+}
+
+// FUNCTION statuses
+void statuses(const span<const path> _Targets, const span<file_info> _Results, const size_t _Threads) {
+    if (_Results.size() < _Targets.size()) {
+        _Throw_system_error("statuses", "buffer too small", error_type::length_error);
+    }
+
+    size_t _Count{_Threads};
+    if (_Count == 0) { // the system calls mostly wait, so use more workers than cores
+        _Count = static_cast<size_t>((_STD max)(_STD thread::hardware_concurrency(), 1u) * _Statuses_threads_per_core);
+    }
+
+    // each worker takes the next chunk, so slow targets don't stop the others,
+    // a few chunks per worker keep all of them busy even if there are only a few targets
+    const size_t _Chunk_size{
+        _STD clamp(_Targets.size() / (_Count * _Statuses_chunks_per_worker), size_t{1}, _Statuses_max_chunk)};
+    const size_t _Chunks{(_Targets.size() + _Chunk_size - 1) / _Chunk_size};
+    _STD atomic<size_t> _Next{0};
+    const auto _Work = [&]() noexcept {
+        for (size_t _Chunk = _Next.fetch_add(1, _STD memory_order_relaxed); _Chunk < _Chunks;
+             _Chunk        = _Next.fetch_add(1, _STD memory_order_relaxed)) {
+            const size_t _First{_Chunk * _Chunk_size};
+            const size_t _Last{(_STD min)(_First + _Chunk_size, _Targets.size())};
+            for (size_t _Idx = _First; _Idx < _Last; ++_Idx) {
+                _Status_or_error(_Targets[_Idx], _Results[_Idx]);
+            }
+        }
+    };
+
+    _Count = (_STD min)(_Count, _Chunks);
+    vector<_STD thread> _Workers;
+    if (_Count > 1) {
+        _Workers.reserve(_Count - 1);
+        _TRY_BEGIN
+        for (size_t _Idx = 1; _Idx < _Count; ++_Idx) {
+            _Workers.emplace_back(_Work);
+        }
+        _CATCH_ALL
+        // failed to start a thread, the started ones and the calling thread will do everything
+        _CATCH_END
+    }
+
+    _Work(); // the calling thread is a worker as well
+    for (_STD thread& _Worker : _Workers) {
+        _Worker.join();
+    }
+}
+
+_NODISCARD vector<file_info> statuses(const span<const path> _Targets, const size_t _Threads) {
+    vector<file_info> _Results(_Targets.size());
+    statuses(_Targets, span<file_info>{_Results}, _Threads);
+    return _Results;
+}
+
 // FUNCTION status_known
-_NODISCARD bool status_known(const file_status _Status) noexcept {
+_NODISCARD bool status_known(const file_status& _Status) noexcept {
     return _Status.type() != file_type::none;
 }
 
@@ -690,7 +912,36 @@ _NODISCARD file_status symlink_status(const path& _Target) noexcept {
 
     return _Status;
 }
+
+// FUNCTION to_local_time
+_NODISCARD file_time to_local_time(const file_clock::time_point _Time) {
+#if _HAS_WINDOWS
+    // convert file time to system time and then to user time zone
+    const int64_t _Ticks{_STD chrono::floor<_STD chrono::duration<int64_t, _STD ratio<1, 10'000'000>>>(
+        _Time.time_since_epoch()).count() + _Filetime_unix_epoch};
+    const FILETIME _File_time{static_cast<unsigned long>(_Ticks), static_cast<unsigned long>(_Ticks >> 32)};
+    SYSTEMTIME _Sys_gen_time; // general system time
+    SYSTEMTIME _Sys_exact_time; // system time in user region
+    _FILESYSTEM_VERIFY(FileTimeToSystemTime(&_File_time, &_Sys_gen_time),
+        "failed to convert file time to system time", error_type::runtime_error);
+    _FILESYSTEM_VERIFY(SystemTimeToTzSpecificLocalTimeEx(nullptr, &_Sys_gen_time, &_Sys_exact_time),
+        "failed to convert general system time to exact system time", error_type::runtime_error);
+    return {_Sys_exact_time.wYear, _Sys_exact_time.wMonth, _Sys_exact_time.wDay,
+        _Sys_exact_time.wHour, _Sys_exact_time.wMinute, _Sys_exact_time.wSecond};
+#else // ^^^ _HAS_WINDOWS ^^^ / vvv !_HAS_WINDOWS vvv
+    // convert to user time zone, the same as Windows version does
+    const time_t _Seconds{static_cast<time_t>(
+        _STD chrono::floor<_STD chrono::seconds>(_Time.time_since_epoch()).count())};
+    tm _Local;
+    _FILESYSTEM_VERIFY(::localtime_r(&_Seconds, &_Local) != nullptr,
+        "failed to convert file time to local time", error_type::runtime_error);
+    return {static_cast<uint16_t>(_Local.tm_year + 1900), static_cast<uint16_t>(_Local.tm_mon + 1),
+        static_cast<uint16_t>(_Local.tm_mday), static_cast<uint16_t>(_Local.tm_hour),
+        static_cast<uint16_t>(_Local.tm_min), static_cast<uint16_t>(_Local.tm_sec)};
+#endif // _HAS_WINDOWS
+}
 _FILESYSTEM_END
 
+#if _HAS_WINDOWS
 #pragma warning(pop)
-#endif // !_HAS_WINDOWS
\ No newline at end of file
+#endif // _HAS_WINDOWS
\ No newline at end of file
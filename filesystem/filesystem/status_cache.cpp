@@ -0,0 +1,476 @@
+// status_cache.cpp
+
+// Copyright (c) Mateusz Jandura. All rights reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#include <filesystem_pch.hpp>
+#include <filesystem.hpp>
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
+#include <unordered_set>
+#if !_HAS_WINDOWS
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+#include <thread>
+#endif // !_HAS_WINDOWS
+
+_FILESYSTEM_BEGIN
+// CONSTANT _Cache_shards
+inline constexpr size_t _Cache_shards = 16; // independent parts of the cache, each has its own lock
+
+// CONSTANT _Cache_sweep_size
+inline constexpr size_t _Cache_sweep_size = 1024; // entries of a shard before the expired ones are erased
+
+#if !_HAS_WINDOWS
+// CONSTANT _Watch_events
+inline constexpr uint32_t _Watch_events = IN_ATTRIB | IN_CLOSE_WRITE | IN_CREATE | IN_DELETE | IN_DELETE_SELF
+                                        | IN_MODIFY | IN_MOVE_SELF | IN_MOVED_FROM | IN_MOVED_TO;
+
+// CONSTANT _Watch_sweep_size
+inline constexpr size_t _Watch_sweep_size = 256; // watches before the unused ones are removed
+#endif // !_HAS_WINDOWS
+
+// STRUCT _Cache_key_hash
+struct _Cache_key_hash { // allows lookups with string_view, so that a cache hit doesn't allocate
+    using is_transparent = void;
+
+    _NODISCARD size_t operator()(const string_view _Key) const noexcept {
+        return _STD hash<string_view>{}(_Key);
+    }
+};
+
+// STRUCT _Cache_entry
+struct _Cache_entry {
+    file_info _Info; // valid only if _Found is true
+    bool _Found; // false if the target doesn't exist
+    _STD chrono::steady_clock::time_point _Expires; // entry is ignored after this point
+};
+
+// STRUCT _Cache_shard
+struct alignas(64) _Cache_shard { // aligned, so that shards never share a cache line
+    _STD shared_mutex _Mutex;
+    _STD unordered_map<string, _Cache_entry, _Cache_key_hash, _STD equal_to<>> _Entries;
+    uint64_t _Generation = 0; // increased by each invalidation, guarded by _Mutex
+    size_t _Sweep_size   = _Cache_sweep_size; // expired entries are erased when the shard reaches this size
+};
+
+// FUNCTION _Cache_directory
+_NODISCARD string_view _Cache_directory(string_view _Key) noexcept {
+    // returns the parent directory of _Key as it is spelled in _Key, empty means the current directory
+    while (_Key.size() > 1 && _Is_slash(_Key.back())) { // "dir/" is a child of "."
+        _Key.remove_suffix(1);
+    }
+
+    const size_t _Pos{_Key.find_last_of(_Has_unexpected_slash ? "/\\" : "/")};
+    if (_Pos == string_view::npos) {
+        return string_view{};
+    }
+
+    return _Pos == 0 ? _Key.substr(0, 1) : _Key.substr(0, _Pos);
+}
+
+// STRUCT _Status_cache_state
+struct _Status_cache_state {
+    explicit _Status_cache_state(const _STD chrono::milliseconds _Time_to_live) : _Ttl(_Time_to_live) {}
+
+    // returns the shard that stores _Key
+    _NODISCARD _Cache_shard& _Shard(const string_view _Key) noexcept {
+        return _Shards[_Cache_key_hash{}(_Key) % _Cache_shards];
+    }
+
+    // removes the entry of _Key (if has)
+    void _Invalidate(const string_view _Key) noexcept {
+        _Cache_shard& _Shard_ref{_Shard(_Key)};
+        const _STD unique_lock _Lock{_Shard_ref._Mutex};
+        const auto _Iter{_Shard_ref._Entries.find(_Key)};
+        if (_Iter != _Shard_ref._Entries.end()) {
+            _Shard_ref._Entries.erase(_Iter);
+        }
+
+        ++_Shard_ref._Generation; // a lookup in progress may have seen the old state
+    }
+
+    // removes the entries of _Directory and everything inside it
+    void _Invalidate_tree(const string_view _Directory) noexcept {
+        if (_Directory.empty()) { // the current directory, every relative key may be affected
+            _Clear();
+            return;
+        }
+
+        const bool _Has_slash{_Directory.back() == '/'}; // only the root directory
+        for (_Cache_shard& _Shard_ref : _Shards) {
+            const _STD unique_lock _Lock{_Shard_ref._Mutex};
+            _STD erase_if(_Shard_ref._Entries, [_Directory, _Has_slash](const auto& _Pair) {
+                const string_view _Key{_Pair.first};
+                return _Key.starts_with(_Directory) && (_Has_slash
+                    || _Key.size() == _Directory.size() || _Key[_Directory.size()] == '/');
+            });
+            ++_Shard_ref._Generation;
+        }
+    }
+
+    // stores _Entry of _Key, unless _Key was invalidated since _Generation was read,
+    // returns true if expired entries were erased
+    bool _Insert(_Cache_shard& _Shard_ref, const string_view _Key, const _Cache_entry& _Entry,
+        const uint64_t _Generation) {
+        const _STD unique_lock _Lock{_Shard_ref._Mutex};
+        if (_Shard_ref._Generation != _Generation) {
+            return false;
+        }
+
+        const bool _Sweep{_Shard_ref._Entries.size() >= _Shard_ref._Sweep_size};
+        if (_Sweep) { // keep only the entries that can still be used
+            const auto _Now{_STD chrono::steady_clock::now()};
+            _STD erase_if(_Shard_ref._Entries, [_Now](const auto& _Pair) {
+                return _Pair.second._Expires <= _Now;
+            });
+
+            // the next sweep after the shard doubles, so that each insertion costs amortized constant time
+            _Shard_ref._Sweep_size = (_STD max)(_Cache_sweep_size, 2 * _Shard_ref._Entries.size());
+        }
+
+        _Shard_ref._Entries.insert_or_assign(string{_Key}, _Entry);
+        return _Sweep;
+    }
+
+    // removes all entries
+    void _Clear() noexcept {
+        for (_Cache_shard& _Shard_ref : _Shards) {
+            const _STD unique_lock _Lock{_Shard_ref._Mutex};
+            _Shard_ref._Entries.clear();
+            ++_Shard_ref._Generation;
+        }
+    }
+
+    const _STD chrono::steady_clock::duration _Ttl; // maximum age of each entry
+    _Cache_shard _Shards[_Cache_shards];
+    _STD atomic<uintmax_t> _Hits{0};
+    _STD atomic<uintmax_t> _Misses{0};
+
+#if !_HAS_WINDOWS
+    // adds a watch for _Directory (empty means the current directory), failures leave only the time limit
+    void _Watch(const string_view _Directory) {
+        if (_Inotify._Get() == -1) {
+            return;
+        }
+
+        { // most misses are in directories that are already watched, so look without blocking other threads
+            const _STD shared_lock _Lock{_Watch_mutex};
+            if (_Watches.find(_Directory) != _Watches.end()) {
+                return;
+            }
+        }
+
+        const _STD lock_guard _Lock{_Watch_mutex};
+        if (_Watches.find(_Directory) != _Watches.end()) { // added by another thread in the meantime
+            return;
+        }
+
+        if (_Watches.size() >= _Watch_sweep) {
+            _Unwatch_unused();
+        }
+
+        const string _Name{_Directory.empty() ? string_view{"."} : _Directory};
+        const int _Wd{::inotify_add_watch(_Inotify._Get(), _Name.c_str(), _Watch_events | IN_ONLYDIR)};
+        if (_Wd != -1) {
+            _Watches.emplace(string{_Directory}, _Wd);
+            _Directories[_Wd].emplace_back(_Directory);
+        }
+    }
+
+    // removes watches of directories whose cached children have expired
+    void _Unwatch_expired() {
+        const _STD lock_guard _Lock{_Watch_mutex};
+        _Unwatch_unused();
+    }
+
+    // removes watches of directories without unexpired cached children, _Watch_mutex must be locked
+    void _Unwatch_unused() {
+        _STD unordered_set<string, _Cache_key_hash, _STD equal_to<>> _Used;
+        const auto _Now{_STD chrono::steady_clock::now()};
+        for (_Cache_shard& _Shard_ref : _Shards) {
+            const _STD shared_lock _Lock{_Shard_ref._Mutex};
+            for (const auto& _Pair : _Shard_ref._Entries) {
+                if (_Now < _Pair.second._Expires) {
+                    _Used.emplace(_Cache_directory(_Pair.first));
+                }
+            }
+        }
+
+        for (auto _Iter = _Watches.begin(); _Iter != _Watches.end();) {
+            if (_Used.find(string_view{_Iter->first}) != _Used.end()) {
+                ++_Iter;
+                continue;
+            }
+
+            // the same directory may be watched under different spellings, the watch is shared by all of them
+            const auto _Found{_Directories.find(_Iter->second)};
+            if (_Found != _Directories.end()) {
+                _STD erase(_Found->second, _Iter->first);
+                if (_Found->second.empty()) {
+                    (void) ::inotify_rm_watch(_Inotify._Get(), _Found->first);
+                    _Directories.erase(_Found);
+                }
+            }
+
+            _Iter = _Watches.erase(_Iter);
+        }
+
+        // the next sweep after the number of watches doubles, like for the entries
+        _Watch_sweep = (_STD max)(_Watch_sweep_size, 2 * _Watches.size());
+    }
+
+    // forgets every watch
+    void _Unwatch_all() noexcept {
+        const _STD lock_guard _Lock{_Watch_mutex};
+        for (const auto& _Pair : _Directories) {
+            (void) ::inotify_rm_watch(_Inotify._Get(), _Pair.first);
+        }
+
+        _Directories.clear();
+        _Watches.clear();
+    }
+
+    // invalidates entries affected by _Event
+    void _Process_event(const inotify_event& _Event) {
+        if ((_Event.mask & IN_Q_OVERFLOW) != 0) { // some events were lost, nothing can be trusted
+            _Clear();
+            return;
+        }
+
+        vector<string> _Spellings; // the same directory may be cached under different names
+        {
+            const _STD lock_guard _Lock{_Watch_mutex};
+            const auto _Iter{_Directories.find(_Event.wd)};
+            if (_Iter == _Directories.end()) {
+                return;
+            }
+
+            _Spellings = _Iter->second;
+            if ((_Event.mask & IN_IGNORED) != 0) { // the watch was removed by the kernel
+                for (const string& _Spelling : _Spellings) {
+                    _Watches.erase(_Spelling);
+                }
+
+                _Directories.erase(_Iter);
+            }
+        }
+
+        const string_view _Name{_Event.len != 0 ? string_view{_Event.name} : string_view{}};
+        for (const string& _Spelling : _Spellings) {
+            if ((_Event.mask & (IN_DELETE_SELF | IN_MOVE_SELF | IN_IGNORED)) != 0) {
+                _Invalidate_tree(_Spelling);
+                continue;
+            }
+
+            if (!_Name.empty()) { // the child changed, it may be cached with a trailing slash as well
+                string _Key{_Child_key(_Spelling, _Name)};
+                _Invalidate(_Key);
+                _Key.push_back('/');
+                _Invalidate(_Key);
+            }
+
+            if (!_Spelling.empty()) { // the directory changed as well (size, times, links)
+                _Invalidate(_Spelling);
+            }
+        }
+    }
+
+    // waits for inotify events until _Wakeup is signaled
+    void _Watch_loop() {
+        pollfd _Fds[2] = {{_Inotify._Get(), POLLIN, 0}, {_Wakeup._Get(), POLLIN, 0}};
+        alignas(inotify_event) char _Buf[4096];
+        for (;;) {
+            if (::poll(_Fds, 2, -1) < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+
+                break; // cannot wait anymore, the time limit still applies
+            }
+
+            if (_Fds[1].revents != 0) { // the cache is being destroyed
+                break;
+            }
+
+            const ssize_t _Bytes{::read(_Inotify._Get(), _Buf, sizeof(_Buf))};
+            if (_Bytes <= 0) {
+                continue;
+            }
+
+            for (ssize_t _Off = 0; _Off < _Bytes;) {
+                const auto _Event{reinterpret_cast<const inotify_event*>(_Buf + _Off)};
+                _Process_event(*_Event);
+                _Off += static_cast<ssize_t>(sizeof(inotify_event) + _Event->len);
+            }
+        }
+    }
+
+    // returns the key of _Name inside _Directory
+    _NODISCARD static string _Child_key(const string_view _Directory, const string_view _Name) {
+        string _Key;
+        _Key.reserve(_Directory.size() + 1 + _Name.size());
+        _Key.append(_Directory);
+        if (!_Directory.empty() && _Directory.back() != '/') {
+            _Key.push_back('/');
+        }
+
+        _Key.append(_Name);
+        return _Key;
+    }
+
+    _Unique_descriptor _Inotify; // inotify instance, -1 if not available
+    _Unique_descriptor _Wakeup; // eventfd that stops _Watcher
+    _STD shared_mutex _Watch_mutex; // guards _Watches and _Directories
+    _STD unordered_map<string, int, _Cache_key_hash, _STD equal_to<>> _Watches; // directory -> watch descriptor
+    _STD unordered_map<int, vector<string>> _Directories; // watch descriptor -> directories
+    size_t _Watch_sweep = _Watch_sweep_size; // unused watches are removed when _Watches reaches this size
+    _STD thread _Watcher; // runs _Watch_loop()
+#endif // !_HAS_WINDOWS
+};
+
+// FUNCTION _Cache_key
+_NODISCARD string_view _Cache_key(const path& _Target) noexcept {
+    // keep the spelling, "file/" must fail even if "file" is cached
+    return path_view{_Target}.view();
+}
+
+// FUNCTION status_cache::status_cache
+status_cache::status_cache(const _STD chrono::milliseconds _Ttl)
+    : _Mystate(_STD make_unique<_Status_cache_state>(_Ttl)) {
+#if !_HAS_WINDOWS
+    // without inotify or eventfd the cache still works, only the time limit applies
+    _Unique_descriptor _Inotify{::inotify_init1(IN_NONBLOCK | IN_CLOEXEC)};
+    _Unique_descriptor _Wakeup{::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC)};
+    if (_Inotify._Get() != -1 && _Wakeup._Get() != -1) {
+        _Mystate->_Inotify = _STD move(_Inotify);
+        _Mystate->_Wakeup  = _STD move(_Wakeup);
+        _Mystate->_Watcher = _STD thread{&_Status_cache_state::_Watch_loop, _Mystate.get()};
+    }
+#endif // !_HAS_WINDOWS
+}
+
+// FUNCTION status_cache::~status_cache
+status_cache::~status_cache() noexcept {
+#if !_HAS_WINDOWS
+    if (_Mystate->_Watcher.joinable()) { // wake up and stop the watcher before the state is destroyed
+        const uint64_t _Signal{1};
+        (void) ::write(_Mystate->_Wakeup._Get(), &_Signal, sizeof(_Signal));
+        _Mystate->_Watcher.join();
+    }
+#endif // !_HAS_WINDOWS
+}
+
+// FUNCTION status_cache::_Lookup
+_NODISCARD bool status_cache::_Lookup(const path& _Target, file_info& _Info) {
+    const string_view _Key{_Cache_key(_Target)};
+    _Cache_shard& _Shard{_Mystate->_Shard(_Key)};
+    uint64_t _Generation;
+    {
+        const _STD shared_lock _Lock{_Shard._Mutex};
+        const auto _Iter{_Shard._Entries.find(_Key)};
+        if (_Iter != _Shard._Entries.end() && _STD chrono::steady_clock::now() < _Iter->second._Expires) {
+            _Mystate->_Hits.fetch_add(1, _STD memory_order_relaxed);
+            _Info = _Iter->second._Info;
+            return _Iter->second._Found;
+        }
+
+        _Generation = _Shard._Generation;
+    }
+
+    _Mystate->_Misses.fetch_add(1, _STD memory_order_relaxed);
+#if !_HAS_WINDOWS
+    // Watch before asking the system, so that no change after the query is missed. If a change was reported
+    // during the query, the generation has changed and the result is returned, but not cached.
+    _Mystate->_Watch(_Cache_directory(_Key));
+    {
+        const _STD shared_lock _Lock{_Shard._Mutex};
+        _Generation = _Shard._Generation;
+    }
+#endif // !_HAS_WINDOWS
+
+    _Cache_entry _Entry;
+    _TRY_BEGIN
+    _Entry._Found = _Try_info(_Target, false, _Entry._Info);
+    _CATCH(const filesystem_error&)
+    // Inaccessible (e.g. no permission), reported as not found, like exists() does. It's not cached,
+    // because permissions of the parent directories may change without any event.
+    _Info = file_info{};
+    return false;
+    _CATCH_END
+
+    _Entry._Expires = _STD chrono::steady_clock::now() + _Mystate->_Ttl;
+    _Info           = _Entry._Info;
+#if _HAS_WINDOWS
+    (void) _Mystate->_Insert(_Shard, _Key, _Entry, _Generation);
+#else // ^^^ _HAS_WINDOWS ^^^ / vvv !_HAS_WINDOWS vvv
+    if (_Mystate->_Insert(_Shard, _Key, _Entry, _Generation)) { // directories of the erased entries may be unused
+        _Mystate->_Unwatch_expired();
+    }
+#endif // _HAS_WINDOWS
+    return _Entry._Found;
+}
+
+// FUNCTION status_cache::clear
+void status_cache::clear() noexcept {
+#if !_HAS_WINDOWS
+    _Mystate->_Unwatch_all();
+#endif // !_HAS_WINDOWS
+    _Mystate->_Clear();
+}
+
+// FUNCTION status_cache::exists
+_NODISCARD bool status_cache::exists(const path& _Target) {
+    file_info _Info;
+    return _Lookup(_Target, _Info);
+}
+
+// FUNCTION status_cache::file_size
+_NODISCARD uintmax_t status_cache::file_size(const path& _Target) {
+    const file_info _Info{info(_Target)};
+    _FILESYSTEM_VERIFY(_Info.type != file_type::directory && _Info.type != file_type::junction,
+        "expected a file", error_type::runtime_error);
+    return _Info.size;
+}
+
+// FUNCTION status_cache::hits
+_NODISCARD uintmax_t status_cache::hits() const noexcept {
+    return _Mystate->_Hits.load(_STD memory_order_relaxed);
+}
+
+// FUNCTION status_cache::info
+_NODISCARD file_info status_cache::info(const path& _Target) {
+    file_info _Info;
+    _FILESYSTEM_VERIFY(_Lookup(_Target, _Info), "target not found", error_type::runtime_error);
+    return _Info;
+}
+
+// FUNCTION status_cache::invalidate
+void status_cache::invalidate(const path& _Target) noexcept {
+    _Mystate->_Invalidate(_Cache_key(_Target));
+}
+
+// FUNCTION status_cache::is_directory
+_NODISCARD bool status_cache::is_directory(const path& _Target) {
+    file_info _Info;
+    return _Lookup(_Target, _Info) && _Info.type == file_type::directory;
+}
+
+// FUNCTION status_cache::is_watching
+_NODISCARD bool status_cache::is_watching() const noexcept {
+#if _HAS_WINDOWS
+    return false;
+#else // ^^^ _HAS_WINDOWS ^^^ / vvv !_HAS_WINDOWS vvv
+    return _Mystate->_Watcher.joinable();
+#endif // _HAS_WINDOWS
+}
+
+// FUNCTION status_cache::misses
+_NODISCARD uintmax_t status_cache::misses() const noexcept {
+    return _Mystate->_Misses.load(_STD memory_order_relaxed);
+}
+_FILESYSTEM_END
\ No newline at end of file
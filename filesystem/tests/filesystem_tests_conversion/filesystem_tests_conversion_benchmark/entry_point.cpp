@@ -0,0 +1,227 @@
+﻿// entry_point.cpp
+
+// Copyright (c) Mateusz Jandura. All rights reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+// Measures throughput (MB/s of UTF-8 text) and heap allocations per call of every _Convert_* direction.
+// Build the Release configuration, on Linux:
+//     g++ -std=c++20 -O2 -I../../../filesystem entry_point.cpp -L<dir> -lfilesystem -o benchmark
+// Pass a part of the direction name as the first argument to run only the matching directions.
+// On Windows filesystem.dll has its own heap and its allocations cannot be counted, "n/a" is printed instead.
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem.hpp>
+#include <new>
+#include <vector>
+#ifdef _MSC_VER
+#ifdef _M_X64
+#ifdef _DEBUG
+#pragma comment(lib, R"(x64\Debug\filesystem.lib)")
+#else // ^^^ _DEBUG ^^^ / vvv NDEBUG vvv
+#pragma comment(lib, R"(x64\Release\filesystem.lib)")
+#endif // _DEBUG
+#else // ^^^ _M_X64 ^^^ / vvv _M_IX86 vvv
+#ifdef _DEBUG
+#pragma comment(lib, R"(Debug\filesystem.lib)")
+#else // ^^^ _DEBUG ^^^ / vvv NDEBUG vvv
+#pragma comment(lib, R"(Release\filesystem.lib)")
+#endif // _DEBUG
+#endif // _M_X64
+#endif // _MSC_VER
+
+// TYPES AND CONSTANTS USED IN BENCHMARKS
+using _FILESYSTEM code_page;
+using _STD span;
+using _STD string;
+using _STD string_view;
+using _STD u16string;
+using _STD u16string_view;
+using _STD u32string;
+using _STD u32string_view;
+using _STD u8string;
+using _STD u8string_view;
+using _STD wstring;
+using _STD wstring_view;
+
+// CONSTANT _Short_length
+inline constexpr size_t _Short_length = 64; // code points in a path-sized corpus
+
+// CONSTANT _Long_size
+inline constexpr size_t _Long_size = 4 * 1024 * 1024; // minimal bytes of UTF-8 in a multi-MB corpus
+
+// CONSTANT _Bytes_per_run
+inline constexpr size_t _Bytes_per_run = 64 * 1024 * 1024; // UTF-8 bytes converted by each measurement
+
+// VARIABLE _Allocations
+static size_t _Allocations = 0; // count of calls to the global operator new
+
+void* operator new(const size_t _Size) {
+    ++_Allocations;
+    if (void* const _Ptr = _CSTD malloc(_Size != 0 ? _Size : 1)) {
+        return _Ptr;
+    }
+
+    throw _STD bad_alloc{};
+}
+
+void* operator new[](const size_t _Size) {
+    return ::operator new(_Size);
+}
+
+void operator delete(void* const _Ptr) noexcept {
+    _CSTD free(_Ptr);
+}
+
+void operator delete[](void* const _Ptr) noexcept {
+    _CSTD free(_Ptr);
+}
+
+void operator delete(void* const _Ptr, size_t) noexcept {
+    _CSTD free(_Ptr);
+}
+
+void operator delete[](void* const _Ptr, size_t) noexcept {
+    _CSTD free(_Ptr);
+}
+
+// STRUCT _Corpus
+struct _Corpus { // the same text in every supported encoding
+    const char* _Name;
+    string _Narrow;
+    u8string _Utf8;
+    u16string _Utf16;
+    u32string _Utf32;
+    wstring _Wide;
+};
+
+// FUNCTION _Make_corpus
+_NODISCARD _Corpus _Make_corpus(const char* const _Name, const u32string_view _Sample, const bool _Long) {
+    u32string _Text;
+    if (_Long) { // repeat the sample until it takes at least _Long_size bytes as UTF-8
+        const size_t _Sample_size = _FILESYSTEM utf8_length_of(_Sample);
+        for (size_t _Size = 0; _Size < _Long_size; _Size += _Sample_size) {
+            _Text.append(_Sample);
+        }
+    } else { // take exactly _Short_length code points
+        while (_Text.size() < _Short_length) {
+            _Text.append(_Sample.substr(0, _Short_length - _Text.size()));
+        }
+    }
+
+    _Corpus _Result{_Name};
+    _Result._Narrow = _FILESYSTEM _Convert_utf_to_narrow(u32string_view{_Text});
+    _Result._Utf8   = _FILESYSTEM _Convert_narrow_to_utf<char8_t>(_Result._Narrow);
+    _Result._Utf16  = _FILESYSTEM _Convert_narrow_to_utf<char16_t>(_Result._Narrow);
+    _Result._Utf32  = _STD move(_Text);
+    _Result._Wide   = _FILESYSTEM _Convert_narrow_to_wide(code_page::utf8, _Result._Narrow);
+    return _Result;
+}
+
+// FUNCTION TEMPLATE _Measure
+template <class _Fn>
+_NODISCARD bool _Measure(const char* const _Direction, const _Corpus& _Text, _Fn _Func) {
+    // every direction either produces or consumes _Text._Narrow, so its size is the amount of work
+    const size_t _Size  = _Text._Narrow.size();
+    const size_t _Count = _Bytes_per_run / _Size != 0 ? _Bytes_per_run / _Size : 1;
+    const bool _Valid   = _Func();
+    size_t _Passed      = 0;
+
+    const size_t _Old_allocations = _Allocations;
+    const auto _Start             = _STD chrono::steady_clock::now();
+    for (size_t _Idx = 0; _Idx < _Count; ++_Idx) {
+        _Passed += _Func();
+    }
+
+    const auto _End              = _STD chrono::steady_clock::now();
+    const double _Seconds        = _STD chrono::duration<double>(_End - _Start).count();
+    const double _Megabytes      = static_cast<double>(_Size) * static_cast<double>(_Count) / (1024.0 * 1024.0);
+#if _HAS_WINDOWS
+    // operator new of this module is never called by filesystem.dll, the count would always be 0
+    (void) _Old_allocations;
+    const char _Allocs_per_call[16] = "n/a";
+#else // ^^^ _HAS_WINDOWS ^^^ / vvv !_HAS_WINDOWS vvv
+    char _Allocs_per_call[16];
+    _CSTD snprintf(_Allocs_per_call, sizeof(_Allocs_per_call), "%.2f",
+        static_cast<double>(_Allocations - _Old_allocations) / static_cast<double>(_Count));
+#endif // _HAS_WINDOWS
+    _CSTD printf("%-36s %-6s %9zu B %10.1f MB/s %6s allocs/call%s\n", _Direction, _Text._Name, _Size,
+        _Megabytes / _Seconds, _Allocs_per_call, _Valid && _Passed == _Count ? "" : "  MISMATCH");
+    return _Valid && _Passed == _Count;
+}
+
+// FUNCTION _Run_corpus
+_NODISCARD bool _Run_corpus(const _Corpus& _Text, const char* const _Filter) {
+    const string_view _Narrow{_Text._Narrow};
+    bool _Result = true;
+    const auto _Run = [&](const char* const _Direction, auto _Func) {
+        if (_Filter == nullptr || _CSTD strstr(_Direction, _Filter) != nullptr) {
+            _Result &= _Measure(_Direction, _Text, _Func);
+        }
+    };
+
+    _Run("_Convert_narrow_to_wide", [&] {
+        return _FILESYSTEM _Convert_narrow_to_wide(code_page::utf8, _Narrow) == _Text._Wide;
+    });
+    _Run("_Convert_narrow_to_wide (span)", [&, _Buf = _STD vector<wchar_t>(_Narrow.size())]() mutable {
+        const size_t _Size = _FILESYSTEM _Convert_narrow_to_wide(code_page::utf8, _Narrow, span<wchar_t>{_Buf});
+        return wstring_view{_Buf.data(), _Size} == _Text._Wide;
+    });
+    _Run("_Convert_wide_to_narrow", [&] {
+        return _FILESYSTEM _Convert_wide_to_narrow(code_page::utf8, _Text._Wide) == _Narrow;
+    });
+    _Run("_Convert_wide_to_narrow (span)", [&, _Buf = _STD vector<char>(_Narrow.size())]() mutable {
+        const size_t _Size = _FILESYSTEM _Convert_wide_to_narrow(code_page::utf8, _Text._Wide, span<char>{_Buf});
+        return string_view{_Buf.data(), _Size} == _Narrow;
+    });
+    _Run("_Convert_narrow_to_utf<char8_t>", [&] {
+        return _FILESYSTEM _Convert_narrow_to_utf<char8_t>(_Narrow) == _Text._Utf8;
+    });
+    _Run("_Convert_narrow_to_utf<char16_t>", [&] {
+        return _FILESYSTEM _Convert_narrow_to_utf<char16_t>(_Narrow) == _Text._Utf16;
+    });
+    _Run("_Convert_narrow_to_utf<char32_t>", [&] {
+        return _FILESYSTEM _Convert_narrow_to_utf<char32_t>(_Narrow) == _Text._Utf32;
+    });
+    _Run("_Convert_narrow_to_utf<wchar_t>", [&] {
+        return _FILESYSTEM _Convert_narrow_to_utf<wchar_t>(_Narrow) == _Text._Wide;
+    });
+    _Run("_Convert_utf_to_narrow<char8_t>", [&] {
+        return _FILESYSTEM _Convert_utf_to_narrow(u8string_view{_Text._Utf8}) == _Narrow;
+    });
+    _Run("_Convert_utf_to_narrow<char16_t>", [&] {
+        return _FILESYSTEM _Convert_utf_to_narrow(u16string_view{_Text._Utf16}) == _Narrow;
+    });
+    _Run("_Convert_utf_to_narrow<char32_t>", [&] {
+        return _FILESYSTEM _Convert_utf_to_narrow(u32string_view{_Text._Utf32}) == _Narrow;
+    });
+    _Run("_Convert_utf_to_narrow<wchar_t>", [&] {
+        return _FILESYSTEM _Convert_utf_to_narrow(wstring_view{_Text._Wide}) == _Narrow;
+    });
+    return _Result;
+}
+
+int main(int _Count, char** _Params) {
+    // samples are written with escapes, so the result does not depend on the source encoding
+    static constexpr u32string_view _Samples[][2] = {
+        {U"ascii", U"/home/user/projects/repository/src/module/file_name.cpp/"},
+        {U"latin", U"/home/u\u017Cytkownik/\u017Ar\u00F3d\u0142a/Stra\u00DFe/caf\u00E9/na\u00EFve/\u00E5ngstr\u00F6m/"},
+        {U"cjk", U"/\u30E6\u30FC\u30B6\u30FC/\u6587\u66F8/\u9879\u76EE/\uC18C\uC2A4/\u6E90\u4EE3\u7801/"},
+        {U"emoji", U"/\U0001F600\U0001F4C1/\U0001F680\U0001F30D/\U0001F389\U0001F4BE/\U0001F40D\U0001F525/"}
+    };
+
+    const char* const _Filter = _Count > 1 ? _Params[1] : nullptr;
+    bool _Result              = true;
+    for (const bool _Long : {false, true}) {
+        for (const auto& _Sample : _Samples) {
+            const string _Name = _FILESYSTEM _Convert_utf_to_narrow(_Sample[0]);
+            const _Corpus& _Text{_Make_corpus(_Long ? "long" : "short", _Sample[1], _Long)};
+            _CSTD printf("\n[%s, %s]\n", _Name.c_str(), _Text._Name);
+            _Result &= _Run_corpus(_Text, _Filter);
+        }
+    }
+
+    return _Result ? EXIT_SUCCESS : EXIT_FAILURE;
+}
\ No newline at end of file